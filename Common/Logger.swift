@@ -27,6 +27,8 @@
 import Foundation
 import OSLog
 
+import RHVoice
+
 fileprivate extension NSLock {
     func withLock<T>(_ body: () -> T) -> T {
         self.lock()
@@ -95,6 +97,8 @@ public class Log {
         }
         set {
             self.logLevelLock.withLock { self._logLevel = newValue }
+            /// Engine drops messages below this level before formatting them
+            RHVoiceBridge.sharedInstance().setMinimumLogLevel(newValue.rhVoiceLogLevel)
         }
     }
     
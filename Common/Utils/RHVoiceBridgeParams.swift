@@ -40,6 +40,23 @@ extension RHVoiceBridgeParams {
         if let pkgPath = FileManager.default.rhvoicePackagePathURL?.path(percentEncoded: false) {
             initParams.pkgPath = pkgPath
         }
+        initParams.minimumLogLevel = Log.logLevel.rhVoiceLogLevel
         return initParams
     }
 }
+
+extension Log.Level {
+    var rhVoiceLogLevel: RHVoiceLogLevel {
+        switch self {
+        case .debug:
+            // Engine trace messages are reported as debug ones
+            return RHVoiceLogLevelTrace
+        case .info:
+            return RHVoiceLogLevelInfo
+        case .warning:
+            return RHVoiceLogLevelWarning
+        case .error:
+            return RHVoiceLogLevelError
+        }
+    }
+}
@@ -0,0 +1,190 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHAsyncLogger.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace RHVoice {
+
+const std::size_t async_logger::record_text_capacity;
+
+namespace {
+
+std::size_t round_up_to_power_of_two(std::size_t value)
+{
+    std::size_t result = 2;
+    while(result < value)
+        result <<= 1;
+    return result;
+}
+
+}
+
+async_logger::async_logger(std::size_t capacity, int min_level, const sink_function& sink):
+    min_level(min_level),
+    sink(sink),
+    mask(round_up_to_power_of_two(capacity) - 1),
+    slots(new slot[mask + 1]),
+    enqueue_position(0),
+    dequeue_position(0),
+    delivered(0),
+    dropped(0),
+    truncated(0),
+    sleeping(false),
+    stopping(false)
+{
+    for(std::size_t index = 0; index <= mask; ++index)
+        slots[index].sequence.store(index, std::memory_order_relaxed);
+    worker = std::thread(&async_logger::work, this);
+}
+
+async_logger::~async_logger()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_available.notify_one();
+    worker.join();
+}
+
+void async_logger::set_min_level(int level)
+{
+    min_level.store(level, std::memory_order_relaxed);
+}
+
+bool async_logger::log(int level, const char* tag, std::size_t tag_size, const char* message, std::size_t message_size)
+{
+    if(!is_enabled(level))
+        return false;
+
+    /// Bounded multi producer queue: a slot is free for position `p` when its sequence equals `p`
+    slot* cell = nullptr;
+    std::size_t position = enqueue_position.load(std::memory_order_relaxed);
+    while(true)
+    {
+        cell = &slots[position & mask];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+        if(difference == 0)
+        {
+            if(enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if(difference < 0)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            position = enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    const std::size_t stored_tag_size = std::min(tag_size, record_text_capacity);
+    const std::size_t stored_message_size = std::min(message_size, record_text_capacity - stored_tag_size);
+    if(stored_tag_size != tag_size || stored_message_size != message_size)
+        truncated.fetch_add(1, std::memory_order_relaxed);
+    cell->level = level;
+    cell->tag_size = static_cast<std::uint16_t>(stored_tag_size);
+    cell->message_size = static_cast<std::uint16_t>(stored_message_size);
+    std::memcpy(cell->text, tag, stored_tag_size);
+    std::memcpy(cell->text + stored_tag_size, message, stored_message_size);
+    /// Sequentially consistent with `sleeping` in `work`: either logger thread sees the record or this thread sees it sleeping
+    cell->sequence.store(position + 1, std::memory_order_seq_cst);
+    if(sleeping.load(std::memory_order_seq_cst))
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        work_available.notify_one();
+    }
+    return true;
+}
+
+void async_logger::flush()
+{
+    const std::size_t target = enqueue_position.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex);
+    work_available.notify_one();
+    progress.wait(lock, [this, target]() {
+        return dequeue_position.load(std::memory_order_acquire) >= target;
+    });
+}
+
+async_logger::statistics async_logger::get_statistics() const
+{
+    statistics result;
+    result.delivered = delivered.load(std::memory_order_relaxed);
+    result.dropped = dropped.load(std::memory_order_relaxed);
+    result.truncated = truncated.load(std::memory_order_relaxed);
+    return result;
+}
+
+bool async_logger::deliver_next()
+{
+    const std::size_t position = dequeue_position.load(std::memory_order_relaxed);
+    slot& cell = slots[position & mask];
+    if(cell.sequence.load(std::memory_order_acquire) != position + 1)
+        return false;
+
+    try
+    {
+        sink(cell.level, cell.text, cell.tag_size, cell.text + cell.tag_size, cell.message_size);
+    }
+    catch(...)
+    {
+    }
+    cell.sequence.store(position + mask + 1, std::memory_order_release);
+    dequeue_position.store(position + 1, std::memory_order_release);
+    delivered.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void async_logger::work()
+{
+    while(true)
+    {
+        while(deliver_next())
+        {
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        progress.notify_all();
+        sleeping.store(true, std::memory_order_seq_cst);
+        /// A record could be published between the last check and `sleeping` becoming visible
+        const std::size_t position = dequeue_position.load(std::memory_order_relaxed);
+        const bool pending = slots[position & mask].sequence.load(std::memory_order_seq_cst) == position + 1;
+        if(!pending)
+        {
+            if(stopping)
+            {
+                sleeping.store(false, std::memory_order_relaxed);
+                return;
+            }
+            work_available.wait(lock);
+        }
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+}
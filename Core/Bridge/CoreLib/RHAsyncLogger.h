@@ -0,0 +1,109 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHAsyncLogger_h
+#define RHAsyncLogger_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace RHVoice {
+
+/// Takes log records off the calling thread. Records below the minimum level are rejected with one atomic load.
+/// Accepted ones are copied as raw bytes into a bounded lock-free ring and handed to `sink` on a background thread,
+/// so any conversion and formatting happens there. Records are dropped, not waited for, when the ring is full.
+class async_logger
+{
+public:
+    /// Called on logger thread. Strings are not null terminated.
+    typedef std::function<void(int level, const char* tag, std::size_t tag_size, const char* message, std::size_t message_size)> sink_function;
+
+    struct statistics
+    {
+        std::uint64_t delivered;
+        std::uint64_t dropped;
+        std::uint64_t truncated;
+    };
+
+    /// `capacity` is rounded up to a power of two
+    async_logger(std::size_t capacity, int min_level, const sink_function& sink);
+    /// Delivers everything that was logged before
+    ~async_logger();
+
+    bool is_enabled(int level) const
+    {
+        return level >= min_level.load(std::memory_order_relaxed);
+    }
+
+    void set_min_level(int level);
+    /// Can be called from any number of threads. Returns false if record was filtered out or dropped.
+    bool log(int level, const char* tag, std::size_t tag_size, const char* message, std::size_t message_size);
+    /// Waits until records logged before the call are delivered
+    void flush();
+    statistics get_statistics() const;
+
+    /// Bytes of tag and message kept per record, the rest is cut
+    static const std::size_t record_text_capacity = 480;
+
+private:
+    struct slot
+    {
+        std::atomic<std::size_t> sequence;
+        int level;
+        std::uint16_t tag_size;
+        std::uint16_t message_size;
+        char text[record_text_capacity];
+    };
+
+    void work();
+    bool deliver_next();
+
+    std::atomic<int> min_level;
+    const sink_function sink;
+    const std::size_t mask;
+    std::unique_ptr<slot[]> slots;
+    std::atomic<std::size_t> enqueue_position;
+    std::atomic<std::size_t> dequeue_position;
+
+    std::atomic<std::uint64_t> delivered;
+    std::atomic<std::uint64_t> dropped;
+    std::atomic<std::uint64_t> truncated;
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable progress;
+    std::atomic<bool> sleeping;
+    bool stopping;
+    std::thread worker;
+
+    async_logger(const async_logger&);
+    async_logger& operator=(const async_logger&);
+};
+
+}
+#endif /* RHAsyncLogger_h */
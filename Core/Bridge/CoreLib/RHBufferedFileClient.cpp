@@ -0,0 +1,147 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHBufferedFileClient.h"
+
+#include <algorithm>
+#include <ctime>
+
+namespace RHVoice {
+
+buffered_file_client::buffered_file_client(audio_file_sink& sink, std::size_t buffer_size):
+    sink(sink),
+    buffer_size(std::max<std::size_t>(buffer_size, 1)),
+    filling(0),
+    pending(false),
+    stopping(false),
+    finished(false),
+    failed(false),
+    sample_count(0),
+    stalls(0),
+    encode_seconds(0)
+{
+    buffers[0].reserve(this->buffer_size);
+    buffers[1].reserve(this->buffer_size);
+    writer = std::thread(&buffered_file_client::work, this);
+}
+
+buffered_file_client::~buffered_file_client()
+{
+    finish();
+}
+
+event_mask buffered_file_client::get_supported_events() const
+{
+    return event_audio;
+}
+
+bool buffered_file_client::play_speech(const short* samples,std::size_t count)
+{
+    if(failed.load())
+        return false;
+
+    while(count > 0)
+    {
+        std::vector<short>& buffer = buffers[filling];
+        const std::size_t size = std::min(count, buffer_size - buffer.size());
+        buffer.insert(buffer.end(), samples, samples + size);
+        samples += size;
+        count -= size;
+        sample_count += size;
+        if(buffer.size() == buffer_size)
+            hand_off();
+    }
+    return !failed.load();
+}
+
+void buffered_file_client::hand_off()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if(pending)
+    {
+        ++stalls;
+        changed.wait(lock, [this]() { return !pending; });
+    }
+    pending = true;
+    filling = 1 - filling;
+    changed.notify_all();
+}
+
+bool buffered_file_client::finish()
+{
+    if(finished)
+        return !failed.load();
+    finished = true;
+
+    if(!buffers[filling].empty())
+        hand_off();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    writer.join();
+
+    if(!sink.finish())
+        failed = true;
+    return !failed.load();
+}
+
+buffered_file_client::statistics buffered_file_client::get_statistics() const
+{
+    statistics result;
+    result.samples = sample_count;
+    result.encode_seconds = encode_seconds;
+    result.stalls = stalls;
+    return result;
+}
+
+void buffered_file_client::work()
+{
+    const double start = thread_cpu_seconds();
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true)
+    {
+        changed.wait(lock, [this]() { return pending || stopping; });
+        if(!pending)
+            break;
+
+        std::vector<short>& buffer = buffers[1 - filling];
+        lock.unlock();
+        if(!failed.load() && !sink.write(buffer.data(), buffer.size()))
+            failed = true;
+        buffer.clear();
+        lock.lock();
+        pending = false;
+        encode_seconds = thread_cpu_seconds() - start;
+        changed.notify_all();
+    }
+}
+
+double buffered_file_client::thread_cpu_seconds()
+{
+    timespec time;
+    if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+        return 0;
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+}
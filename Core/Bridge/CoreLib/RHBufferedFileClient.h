@@ -0,0 +1,102 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+#ifndef RHBufferedFileClient_h
+#define RHBufferedFileClient_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/client.hpp"
+
+namespace RHVoice {
+
+/// Destination of 16 bit mono samples, e.g. an encoder writing a file. Used from one thread at a time.
+class audio_file_sink
+{
+public:
+    virtual ~audio_file_sink() {}
+    virtual bool write(const short* samples,std::size_t count) = 0;
+    /// Flushes encoder and closes file
+    virtual bool finish() = 0;
+};
+
+/// Client that takes writing and encoding off the synthesis thread.
+/// Samples are copied into one of two preallocated buffers, a full buffer is handed to a writer thread
+/// that passes it to `sink` while engine fills the other one. Engine only waits when the writer is
+/// a whole buffer behind.
+class buffered_file_client: public RHVoice::client
+{
+public:
+    struct statistics
+    {
+        std::uint64_t samples;
+        /// CPU time of writer thread, i.e. spent in `sink`
+        double encode_seconds;
+        /// How many times synthesis waited for the writer
+        std::size_t stalls;
+    };
+
+    /// `buffer_size` is in samples
+    buffered_file_client(audio_file_sink& sink, std::size_t buffer_size);
+    ~buffered_file_client();
+
+    event_mask get_supported_events() const override;
+    bool play_speech(const short* samples,std::size_t count) override;
+    /// Writes what is left, stops writer thread and finishes `sink`. Returns false if anything failed to write.
+    bool finish();
+    /// Valid after `finish`
+    statistics get_statistics() const;
+
+private:
+    void hand_off();
+    void work();
+    static double thread_cpu_seconds();
+
+    audio_file_sink& sink;
+    const std::size_t buffer_size;
+    std::vector<short> buffers[2];
+    std::size_t filling;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool pending;
+    bool stopping;
+    bool finished;
+    std::atomic<bool> failed;
+
+    std::uint64_t sample_count;
+    std::size_t stalls;
+    double encode_seconds;
+    std::thread writer;
+
+    buffered_file_client(const buffered_file_client&);
+    buffered_file_client& operator=(const buffered_file_client&);
+};
+
+}
+#endif /* RHBufferedFileClient_h */
@@ -0,0 +1,89 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHCancellableClient.h"
+
+#include "RHTrace.h"
+
+namespace RHVoice {
+
+cancellable_client::cancellable_client(client& owner, const std::atomic<bool>& cancelled):
+    owner(owner),
+    cancelled(cancelled),
+    owner_events(owner.get_supported_events()),
+    audio_started(false)
+{
+}
+
+event_mask cancellable_client::get_supported_events() const
+{
+    return owner_events | event_word_starts | event_sentence_starts;
+}
+
+unsigned int cancellable_client::get_audio_buffer_size() const
+{
+    return owner.get_audio_buffer_size();
+}
+
+bool cancellable_client::play_speech(const short* samples,std::size_t count)
+{
+    if(cancelled)
+        return false;
+    if(!audio_started)
+    {
+        audio_started = true;
+        RH_TRACE_INSTANT("client.first_audio");
+    }
+    RH_TRACE_SPAN("client.play_speech");
+    return owner.play_speech(samples, count);
+}
+
+bool cancellable_client::word_starts(std::size_t position,std::size_t length)
+{
+    if(cancelled)
+        return false;
+    if(owner_events & event_word_starts)
+    {
+        RH_TRACE_SPAN("client.word_starts");
+        return owner.word_starts(position, length);
+    }
+    return true;
+}
+
+bool cancellable_client::sentence_starts(std::size_t position,std::size_t length)
+{
+    if(cancelled)
+        return false;
+    if(owner_events & event_sentence_starts)
+    {
+        RH_TRACE_SPAN("client.sentence_starts");
+        return owner.sentence_starts(position, length);
+    }
+    return true;
+}
+
+void cancellable_client::done()
+{
+    if(!cancelled && (owner_events & event_done))
+        owner.done();
+}
+
+}
@@ -0,0 +1,55 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHCancellableClient_h
+#define RHCancellableClient_h
+
+#include <atomic>
+#include <cstddef>
+
+#include "core/client.hpp"
+
+namespace RHVoice {
+
+/// Forwards events to `owner` and tells engine to stop as soon as `cancelled` is set.
+/// Word and sentence events are requested even if owner does not need them,
+/// so engine reaches a cancellation check between words, not only between audio chunks.
+class cancellable_client: public RHVoice::client
+{
+public:
+    cancellable_client(client& owner, const std::atomic<bool>& cancelled);
+    event_mask get_supported_events() const override;
+    unsigned int get_audio_buffer_size() const override;
+    bool play_speech(const short* samples,std::size_t count) override;
+    bool word_starts(std::size_t position,std::size_t length) override;
+    bool sentence_starts(std::size_t position,std::size_t length) override;
+    /// Not forwarded for cancelled synthesis
+    void done() override;
+
+private:
+    client& owner;
+    const std::atomic<bool>& cancelled;
+    const event_mask owner_events;
+    bool audio_started;
+};
+
+}
+#endif /* RHCancellableClient_h */
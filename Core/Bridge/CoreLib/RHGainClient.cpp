@@ -0,0 +1,76 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHGainClient.h"
+
+#include <cmath>
+#include <limits>
+
+namespace RHVoice {
+
+gain_client::gain_client(client& owner, double gain):
+    owner(owner),
+    gain(gain)
+{
+}
+
+event_mask gain_client::get_supported_events() const
+{
+    return owner.get_supported_events();
+}
+
+unsigned int gain_client::get_audio_buffer_size() const
+{
+    return owner.get_audio_buffer_size();
+}
+
+bool gain_client::play_speech(const short* samples,std::size_t count)
+{
+    if(gain == 1.0)
+        return owner.play_speech(samples, count);
+
+    const double min_sample = std::numeric_limits<short>::min();
+    const double max_sample = std::numeric_limits<short>::max();
+    scaled.resize(count);
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const double value = std::floor(samples[index] * gain + 0.5);
+        scaled[index] = static_cast<short>(value < min_sample ? min_sample : (value > max_sample ? max_sample : value));
+    }
+    return owner.play_speech(scaled.data(), count);
+}
+
+bool gain_client::word_starts(std::size_t position,std::size_t length)
+{
+    return owner.word_starts(position, length);
+}
+
+bool gain_client::sentence_starts(std::size_t position,std::size_t length)
+{
+    return owner.sentence_starts(position, length);
+}
+
+void gain_client::done()
+{
+    owner.done();
+}
+
+}
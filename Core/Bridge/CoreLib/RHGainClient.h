@@ -0,0 +1,52 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHGainClient_h
+#define RHGainClient_h
+
+#include <cstddef>
+#include <vector>
+
+#include "core/client.hpp"
+
+namespace RHVoice {
+
+/// Forwards events to `owner` with audio scaled by `gain` and saturated to 16 bit,
+/// so audio synthesized or cached at volume 1 can be played at any volume.
+class gain_client: public RHVoice::client
+{
+public:
+    gain_client(client& owner, double gain);
+    event_mask get_supported_events() const override;
+    unsigned int get_audio_buffer_size() const override;
+    bool play_speech(const short* samples,std::size_t count) override;
+    bool word_starts(std::size_t position,std::size_t length) override;
+    bool sentence_starts(std::size_t position,std::size_t length) override;
+    void done() override;
+
+private:
+    client& owner;
+    const double gain;
+    std::vector<short> scaled;
+};
+
+}
+#endif /* RHGainClient_h */
@@ -0,0 +1,228 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHIncrementalDocument.h"
+#include "RHSentenceSplitter.h"
+#include "RHTrace.h"
+
+#include <chrono>
+
+namespace RHVoice {
+
+namespace {
+
+/// Cancellation flag is set without notifying the text, so waiting for more text wakes up to check it
+const std::chrono::milliseconds cancellation_check_interval(10);
+
+/// Shifts marker positions of one piece to the whole text and keeps `done` until the last piece
+class piece_client: public RHVoice::client
+{
+public:
+    piece_client(client& owner, std::size_t position_offset):
+        owner(owner),
+        position_offset(position_offset),
+        stopped(false)
+    {
+    }
+
+    event_mask get_supported_events() const override
+    {
+        return owner.get_supported_events() & ~event_done;
+    }
+
+    unsigned int get_audio_buffer_size() const override
+    {
+        return owner.get_audio_buffer_size();
+    }
+
+    bool play_speech(const short* samples,std::size_t count) override
+    {
+        return keep_going(owner.play_speech(samples, count));
+    }
+
+    bool word_starts(std::size_t position,std::size_t length) override
+    {
+        return keep_going(owner.word_starts(position + position_offset, length));
+    }
+
+    bool sentence_starts(std::size_t position,std::size_t length) override
+    {
+        return keep_going(owner.sentence_starts(position + position_offset, length));
+    }
+
+    void done() override
+    {
+    }
+
+    bool is_stopped() const
+    {
+        return stopped;
+    }
+
+private:
+    bool keep_going(bool result)
+    {
+        if(!result)
+            stopped = true;
+        return result;
+    }
+
+    client& owner;
+    const std::size_t position_offset;
+    bool stopped;
+};
+
+}
+
+incremental_text::incremental_text():
+    finished(false)
+{
+}
+
+void incremental_text::append(const char* data, std::size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(finished)
+            return;
+        text.append(data, size);
+    }
+    text_appended.notify_all();
+}
+
+void incremental_text::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    text_appended.notify_all();
+}
+
+bool incremental_text::is_finished() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return finished;
+}
+
+std::size_t incremental_text::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return text.size();
+}
+
+bool incremental_text::wait_for_piece(std::size_t position, std::string& piece, const std::atomic<bool>* cancelled)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    std::size_t piece_end = position;
+    while(true)
+    {
+        if(cancelled != nullptr && *cancelled)
+            return false;
+
+        if(finished)
+        {
+            if(text.size() <= position)
+                return false;
+            piece_end = text.size();
+            break;
+        }
+
+        /// Only the unfinished sentence is scanned again after each append
+        const std::size_t sentence_end = find_last_sentence_end(text.data() + position, text.size() - position);
+        if(sentence_end != 0)
+        {
+            piece_end = position + sentence_end;
+            break;
+        }
+
+        if(cancelled == nullptr)
+            text_appended.wait(lock);
+        else
+            text_appended.wait_for(lock, cancellation_check_interval);
+    }
+
+    piece.assign(text, position, piece_end - position);
+    return true;
+}
+
+incremental_document_settings::incremental_document_settings():
+    rate(1.0),
+    volume(1.0),
+    quality("standard"),
+    position_offset(0),
+    cancellation(nullptr)
+{
+}
+
+incremental_document::incremental_document(const std::shared_ptr<engine>& engine, const std::shared_ptr<incremental_text>& text, const incremental_document_settings& settings):
+    engine_ptr(engine),
+    text(text),
+    settings(settings),
+    owner(nullptr),
+    pieces_synthesized(0)
+{
+}
+
+void incremental_document::set_owner(client& owner)
+{
+    this->owner = &owner;
+}
+
+std::size_t incremental_document::piece_count() const
+{
+    return pieces_synthesized;
+}
+
+bool incremental_document::is_cancelled_by_caller() const
+{
+    return settings.cancellation != nullptr && *settings.cancellation;
+}
+
+void incremental_document::synthesize()
+{
+    if(owner == nullptr)
+        return;
+
+    std::size_t position = 0;
+    std::string piece;
+    while(text->wait_for_piece(position, piece, settings.cancellation))
+    {
+        RH_TRACE_SPAN("incremental.piece");
+        piece_client piece_owner(*owner, settings.position_offset + position);
+        std::unique_ptr<document> doc = document::create_from_plain_text(engine_ptr, piece.begin(), piece.end(), content_text, settings.profile);
+        doc->speech_settings.relative.rate = settings.rate;
+        doc->speech_settings.relative.volume = settings.volume;
+        doc->quality.set_from_string(settings.quality);
+        doc->set_owner(piece_owner);
+        doc->synthesize();
+
+        ++pieces_synthesized;
+        if(piece_owner.is_stopped() || is_cancelled_by_caller())
+            return;
+        position += piece.size();
+    }
+
+    if(!is_cancelled_by_caller() && (owner->get_supported_events() & event_done))
+        owner->done();
+}
+
+}
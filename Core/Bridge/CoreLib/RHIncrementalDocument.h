@@ -0,0 +1,106 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHIncrementalDocument_h
+#define RHIncrementalDocument_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "core/engine.hpp"
+#include "core/document.hpp"
+#include "core/client.hpp"
+
+namespace RHVoice {
+
+/// UTF-8 plain text that arrives in chunks, e.g. from a caption feed or a text generator.
+/// Writer appends chunks and marks end of input, reader takes complete sentences as soon as they are known.
+class incremental_text
+{
+public:
+    incremental_text();
+
+    void append(const char* data, std::size_t size);
+    /// No more text will be appended, the unfinished tail becomes the last piece
+    void finish();
+    bool is_finished() const;
+    std::size_t size() const;
+
+    /// Waits until text after `position` has a confirmed sentence end, or input is finished.
+    /// A sentence end is confirmed only once the next sentence has started, so "e.g. this" or "1." followed
+    /// by more digits is not cut too early. Copies text from `position` up to the last confirmed end, or to the end
+    /// of text once input is finished, into `piece`.
+    /// Returns false when input is finished and nothing is left after `position`, or when `cancelled` is set.
+    bool wait_for_piece(std::size_t position, std::string& piece, const std::atomic<bool>* cancelled);
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable text_appended;
+    std::string text;
+    bool finished;
+
+    incremental_text(const incremental_text&);
+    incremental_text& operator=(const incremental_text&);
+};
+
+struct incremental_document_settings
+{
+    incremental_document_settings();
+
+    voice_profile profile;
+    double rate;
+    double volume;
+    std::string quality;
+    /// Added to marker positions
+    std::size_t position_offset;
+    /// When set, waiting for more text stops shortly after it becomes true. Has to outlive the document
+    const std::atomic<bool>* cancellation;
+};
+
+/// Synthesizes `incremental_text` while it is still being appended.
+/// Every confirmed piece is synthesized by its own `document`, starting as soon as the piece is available,
+/// with marker positions relative to the beginning of the whole text. Owner gets `done` once, after the last piece.
+class incremental_document
+{
+public:
+    incremental_document(const std::shared_ptr<engine>& engine, const std::shared_ptr<incremental_text>& text, const incremental_document_settings& settings);
+
+    void set_owner(client& owner);
+    /// Returns when all text is synthesized after input was finished, owner asked to stop or cancellation was set
+    void synthesize();
+    std::size_t piece_count() const;
+
+private:
+    bool is_cancelled_by_caller() const;
+
+    std::shared_ptr<engine> engine_ptr;
+    std::shared_ptr<incremental_text> text;
+    incremental_document_settings settings;
+    client* owner;
+    std::size_t pieces_synthesized;
+};
+
+}
+#endif /* RHIncrementalDocument_h */
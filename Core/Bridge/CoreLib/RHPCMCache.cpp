@@ -0,0 +1,336 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+
+#include "RHPCMCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+
+#include "RHTrace.h"
+
+using namespace RHVoice;
+
+namespace
+{
+    const char cache_file_magic[4] = {'R', 'H', 'U', 'C'};
+    const std::uint32_t cache_file_version = 1;
+    /// Cached recordings are only replayed, nothing records into them any more
+    const std::atomic<bool> never_cancelled(false);
+
+    /// Returns null if file is missing or broken. The file is removed either way.
+    std::shared_ptr<const recording_client> read_cache_file(const std::string& file_path, const std::string& key)
+    {
+        std::shared_ptr<recording_client> result;
+        std::ifstream stream(file_path.c_str(), std::ios::binary);
+        char magic[sizeof(cache_file_magic)];
+        std::uint32_t version = 0;
+        std::uint64_t key_size = 0;
+        stream.read(magic, sizeof(magic));
+        stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+        stream.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+        if(stream && std::equal(magic, magic + sizeof(magic), cache_file_magic) && version == cache_file_version && key_size == key.size())
+        {
+            std::string stored_key(key_size, '\0');
+            stream.read(&stored_key[0], key_size);
+            result = std::make_shared<recording_client>(event_audio | event_word_starts | event_sentence_starts, 0, never_cancelled);
+            if(!stream || stored_key != key || !result->load(stream))
+                result.reset();
+        }
+        stream.close();
+        std::remove(file_path.c_str());
+        return result;
+    }
+
+    /// Returns size of the written file, or 0 if writing failed and nothing is left on disk
+    std::size_t write_cache_file(const std::string& file_path, const std::string& key, const recording_client& recording)
+    {
+        std::ofstream stream(file_path.c_str(), std::ios::binary | std::ios::trunc);
+        const std::uint64_t key_size = key.size();
+        stream.write(cache_file_magic, sizeof(cache_file_magic));
+        stream.write(reinterpret_cast<const char*>(&cache_file_version), sizeof(cache_file_version));
+        stream.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+        stream.write(key.data(), key.size());
+        recording.save(stream);
+        const std::streamoff size = stream.tellp();
+        stream.close();
+        if(!stream || size <= 0)
+        {
+            std::remove(file_path.c_str());
+            return 0;
+        }
+        return static_cast<std::size_t>(size);
+    }
+
+    void remove_files(const std::vector<std::string>& file_paths)
+    {
+        for(const std::string& file_path: file_paths)
+            std::remove(file_path.c_str());
+    }
+}
+
+utterance_cache::utterance_cache(std::size_t memory_capacity, const std::string& disk_path, std::size_t disk_capacity):
+    memory_capacity(memory_capacity),
+    disk_path(disk_path),
+    disk_capacity(disk_capacity),
+    next_file_number(0),
+    generation(0),
+    memory_bytes(0),
+    disk_bytes(0),
+    hits(0),
+    disk_hits(0),
+    misses(0)
+{
+}
+
+std::shared_ptr<const recording_client> utterance_cache::find(const std::string& key)
+{
+    RH_TRACE_SPAN("cache.find");
+    std::vector<std::string> file_paths;
+    std::uint64_t find_generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_map<std::string, entry_list::iterator>::iterator found = index.find(key);
+        if(found != index.end())
+        {
+            entries.splice(entries.begin(), entries, found->second);
+            ++hits;
+            return found->second->second;
+        }
+
+        /// Entry is moved back to memory, or it is broken
+        remove_from_disk(key, file_paths);
+        if(file_paths.empty())
+        {
+            ++misses;
+            return std::shared_ptr<const recording_client>();
+        }
+        find_generation = generation;
+    }
+
+    const std::shared_ptr<const recording_client> result = read_cache_file(file_paths.front(), key);
+    file_paths.clear();
+    pending_write_list writes;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!result)
+        {
+            ++misses;
+            return result;
+        }
+
+        ++hits;
+        ++disk_hits;
+        if(find_generation == generation && index.find(key) == index.end())
+        {
+            /// Written again by another thread meanwhile
+            remove_from_disk(key, file_paths);
+            entries.push_front(std::make_pair(key, result));
+            index[key] = entries.begin();
+            memory_bytes += result->memory_size();
+            evict(writes);
+        }
+    }
+    remove_files(file_paths);
+    write_to_disk(writes);
+    return result;
+}
+
+void utterance_cache::insert(const std::string& key, const std::shared_ptr<const recording_client>& recording)
+{
+    RH_TRACE_SPAN("cache.insert");
+    if(!recording || recording->memory_size() > memory_capacity)
+        return;
+
+    std::vector<std::string> file_paths;
+    pending_write_list writes;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_map<std::string, entry_list::iterator>::iterator found = index.find(key);
+        if(found != index.end())
+        {
+            memory_bytes -= found->second->second->memory_size();
+            entries.erase(found->second);
+            index.erase(found);
+        }
+        /// Older recording can't be found any more, since memory is looked up first
+        remove_from_disk(key, file_paths);
+
+        entries.push_front(std::make_pair(key, recording));
+        index[key] = entries.begin();
+        memory_bytes += recording->memory_size();
+        evict(writes);
+    }
+    remove_files(file_paths);
+    write_to_disk(writes);
+}
+
+void utterance_cache::clear()
+{
+    std::vector<std::string> file_paths;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        index.clear();
+        memory_bytes = 0;
+        ++generation;
+        while(!disk_entries.empty())
+            remove_from_disk(disk_entries.front().key, file_paths);
+    }
+    remove_files(file_paths);
+}
+
+utterance_cache::statistics utterance_cache::get_statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    statistics result;
+    result.hits = hits;
+    result.disk_hits = disk_hits;
+    result.misses = misses;
+    result.memory_bytes = memory_bytes;
+    result.disk_bytes = disk_bytes;
+    result.entry_count = entries.size() + disk_entries.size();
+    return result;
+}
+
+void utterance_cache::evict(pending_write_list& writes)
+{
+    while(memory_bytes > memory_capacity && !entries.empty())
+    {
+        const entry_list::value_type& last = entries.back();
+        memory_bytes -= last.second->memory_size();
+        if(!disk_path.empty())
+        {
+            pending_write write;
+            write.key = last.first;
+            write.recording = last.second;
+            write.file_number = next_file_number++;
+            write.generation = generation;
+            writes.push_back(write);
+        }
+        index.erase(last.first);
+        entries.pop_back();
+    }
+}
+
+void utterance_cache::write_to_disk(const pending_write_list& writes)
+{
+    std::vector<std::string> file_paths;
+    for(const pending_write& write: writes)
+    {
+        const std::string file_path = disk_file_path(write.key, write.file_number);
+        const std::size_t size = write_cache_file(file_path, write.key, *write.recording);
+        if(size == 0)
+            continue;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        /// Cleared meanwhile, or a newer recording is in memory already
+        if(write.generation != generation || index.find(write.key) != index.end())
+        {
+            file_paths.push_back(file_path);
+            continue;
+        }
+
+        remove_from_disk(write.key, file_paths);
+        disk_entry entry;
+        entry.key = write.key;
+        entry.size = size;
+        entry.file_number = write.file_number;
+        disk_entries.push_back(entry);
+        disk_bytes += entry.size;
+        while(disk_bytes > disk_capacity && !disk_entries.empty())
+            remove_from_disk(disk_entries.front().key, file_paths);
+    }
+    remove_files(file_paths);
+}
+
+void utterance_cache::remove_from_disk(const std::string& key, std::vector<std::string>& removed_files)
+{
+    for(disk_entry_list::iterator it = disk_entries.begin(); it != disk_entries.end(); ++it)
+    {
+        if(it->key != key)
+            continue;
+        disk_bytes -= it->size;
+        removed_files.push_back(disk_file_path(key, it->file_number));
+        disk_entries.erase(it);
+        return;
+    }
+}
+
+std::string utterance_cache::disk_file_path(const std::string& key, std::uint64_t file_number) const
+{
+    return disk_path + "/" + std::to_string(std::hash<std::string>()(key)) + "-" + std::to_string(file_number) + ".rhuc";
+}
+
+caching_client::caching_client(client& owner, utterance_cache& cache, const std::string& key):
+    owner(owner),
+    cache(cache),
+    key(key),
+    owner_events(owner.get_supported_events()),
+    stopped(false),
+    recording(std::make_shared<recording_client>(event_audio | event_word_starts | event_sentence_starts, owner.get_audio_buffer_size(), never_cancelled))
+{
+}
+
+event_mask caching_client::get_supported_events() const
+{
+    /// Everything is recorded, so a hit can serve any later owner
+    return owner_events | event_audio | event_word_starts | event_sentence_starts;
+}
+
+unsigned int caching_client::get_audio_buffer_size() const
+{
+    return owner.get_audio_buffer_size();
+}
+
+bool caching_client::play_speech(const short* samples,std::size_t count)
+{
+    recording->play_speech(samples, count);
+    if(!owner.play_speech(samples, count))
+        stopped = true;
+    return !stopped;
+}
+
+bool caching_client::word_starts(std::size_t position,std::size_t length)
+{
+    recording->word_starts(position, length);
+    if((owner_events & event_word_starts) && !owner.word_starts(position, length))
+        stopped = true;
+    return !stopped;
+}
+
+bool caching_client::sentence_starts(std::size_t position,std::size_t length)
+{
+    recording->sentence_starts(position, length);
+    if((owner_events & event_sentence_starts) && !owner.sentence_starts(position, length))
+        stopped = true;
+    return !stopped;
+}
+
+void caching_client::done()
+{
+    if(!stopped)
+        cache.insert(key, recording);
+    if(owner_events & event_done)
+        owner.done();
+}
@@ -0,0 +1,138 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+
+#ifndef RHPCMCache_h
+#define RHPCMCache_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/client.hpp"
+
+#include "RHParallelDocument.h"
+
+namespace RHVoice {
+
+/// Bounded LRU cache of synthesized audio and markers keyed by everything that affects synthesis result.
+/// Entries evicted from memory are written to `disk_path` if it is not empty and are loaded back on hit.
+/// Files are read, written and removed without holding the cache lock.
+class utterance_cache
+{
+public:
+    struct statistics
+    {
+        std::uint64_t hits;
+        std::uint64_t disk_hits;
+        std::uint64_t misses;
+        std::size_t memory_bytes;
+        std::size_t disk_bytes;
+        std::size_t entry_count;
+    };
+
+    utterance_cache(std::size_t memory_capacity, const std::string& disk_path, std::size_t disk_capacity);
+
+    std::shared_ptr<const recording_client> find(const std::string& key);
+    void insert(const std::string& key, const std::shared_ptr<const recording_client>& recording);
+    void clear();
+    statistics get_statistics() const;
+
+private:
+    typedef std::list<std::pair<std::string, std::shared_ptr<const recording_client>>> entry_list;
+
+    struct disk_entry
+    {
+        std::string key;
+        std::size_t size;
+        /// Unique within cache, so keys with equal hashes never share a file
+        std::uint64_t file_number;
+    };
+    typedef std::list<disk_entry> disk_entry_list;
+
+    /// Evicted entry that is not in memory any more and is not on disk yet
+    struct pending_write
+    {
+        std::string key;
+        std::shared_ptr<const recording_client> recording;
+        std::uint64_t file_number;
+        std::uint64_t generation;
+    };
+    typedef std::vector<pending_write> pending_write_list;
+
+    /// Must be called with `mutex` locked
+    void evict(pending_write_list& writes);
+    /// Must be called without `mutex` locked
+    void write_to_disk(const pending_write_list& writes);
+    /// Must be called with `mutex` locked. Path of the file to remove is appended to `removed_files`.
+    void remove_from_disk(const std::string& key, std::vector<std::string>& removed_files);
+    std::string disk_file_path(const std::string& key, std::uint64_t file_number) const;
+
+    const std::size_t memory_capacity;
+    const std::string disk_path;
+    const std::size_t disk_capacity;
+
+    mutable std::mutex mutex;
+    entry_list entries;
+    std::unordered_map<std::string, entry_list::iterator> index;
+    /// Least recently written first
+    disk_entry_list disk_entries;
+    std::uint64_t next_file_number;
+    /// Changed by `clear`, so writes and loads started before it are dropped
+    std::uint64_t generation;
+    std::size_t memory_bytes;
+    std::size_t disk_bytes;
+    std::uint64_t hits;
+    std::uint64_t disk_hits;
+    std::uint64_t misses;
+};
+
+/// Forwards everything to `owner` while recording it. Recording is put into `cache`
+/// when synthesis is done and nobody asked to stop.
+class caching_client: public RHVoice::client
+{
+public:
+    caching_client(client& owner, utterance_cache& cache, const std::string& key);
+    event_mask get_supported_events() const override;
+    unsigned int get_audio_buffer_size() const override;
+    bool play_speech(const short* samples,std::size_t count) override;
+    bool word_starts(std::size_t position,std::size_t length) override;
+    bool sentence_starts(std::size_t position,std::size_t length) override;
+    void done() override;
+
+private:
+    client& owner;
+    utterance_cache& cache;
+    const std::string key;
+    const event_mask owner_events;
+    std::atomic<bool> stopped;
+    /// Outlives this client in the cache, so it must not refer to `stopped`
+    std::shared_ptr<recording_client> recording;
+};
+
+}
+#endif /* RHPCMCache_h */
@@ -0,0 +1,230 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHPCMRingBuffer.h"
+
+#include <algorithm>
+
+using namespace RHVoice;
+
+namespace {
+
+std::size_t round_up_to_power_of_two(std::size_t value)
+{
+    std::size_t result = 1;
+    while(result < value)
+        result <<= 1;
+    return result;
+}
+
+const float sample_scale = 1.0f / 32768.0f;
+
+/// Longest a producer sleeps when a wakeup from the consumer was missed
+const std::chrono::milliseconds producer_poll_interval(2);
+
+}
+
+pcm_ring_buffer::pcm_ring_buffer(std::size_t capacity):
+    mask(round_up_to_power_of_two(std::max<std::size_t>(capacity, 2)) - 1),
+    buffer(new short[mask + 1]),
+    write_index(0),
+    read_index(0),
+    finished(false),
+    cancelled(false),
+    producer_waiting(false),
+    consumer_waiting(false)
+{
+}
+
+std::size_t pcm_ring_buffer::try_write(const short* samples, std::size_t count)
+{
+    const std::size_t write_position = write_index.load(std::memory_order_relaxed);
+    const std::size_t read_position = read_index.load(std::memory_order_acquire);
+    const std::size_t free_space = capacity() - (write_position - read_position);
+    const std::size_t to_write = std::min(count, free_space);
+    if(to_write == 0)
+        return 0;
+
+    const std::size_t offset = write_position & mask;
+    const std::size_t first_part = std::min(to_write, capacity() - offset);
+    std::copy(samples, samples + first_part, buffer.get() + offset);
+    std::copy(samples + first_part, samples + to_write, buffer.get());
+
+    write_index.store(write_position + to_write, std::memory_order_seq_cst);
+    wake(consumer_waiting);
+    return to_write;
+}
+
+bool pcm_ring_buffer::write(const short* samples, std::size_t count)
+{
+    while(count > 0)
+    {
+        if(is_cancelled())
+            return false;
+
+        const std::size_t written = try_write(samples, count);
+        samples += written;
+        count -= written;
+        if(count == 0)
+            break;
+
+        wait_until(producer_waiting, std::chrono::steady_clock::time_point::max(), [this] {
+            return cancelled.load() || size() < capacity();
+        });
+    }
+    return !is_cancelled();
+}
+
+template<typename T, typename Convert>
+std::size_t pcm_ring_buffer::read_converted(T* output, std::size_t count, Convert convert)
+{
+    const std::size_t read_position = read_index.load(std::memory_order_relaxed);
+    const std::size_t write_position = write_index.load(std::memory_order_acquire);
+    const std::size_t to_read = std::min(count, write_position - read_position);
+    if(to_read == 0)
+        return 0;
+
+    const std::size_t offset = read_position & mask;
+    const std::size_t first_part = std::min(to_read, capacity() - offset);
+    std::transform(buffer.get() + offset, buffer.get() + offset + first_part, output, convert);
+    std::transform(buffer.get(), buffer.get() + (to_read - first_part), output + first_part, convert);
+
+    read_index.store(read_position + to_read, std::memory_order_seq_cst);
+    try_wake(producer_waiting);
+    return to_read;
+}
+
+std::size_t pcm_ring_buffer::read(short* samples, std::size_t count)
+{
+    return read_converted(samples, count, [](short sample) { return sample; });
+}
+
+std::size_t pcm_ring_buffer::read(float* frames, std::size_t count)
+{
+    return read_converted(frames, count, [](short sample) { return sample * sample_scale; });
+}
+
+template<typename Predicate>
+bool pcm_ring_buffer::wait_until(std::atomic<bool>& waiting, std::chrono::steady_clock::time_point deadline, Predicate predicate)
+{
+    if(predicate())
+        return true;
+
+    const bool polling = &waiting == &producer_waiting;
+    std::unique_lock<std::mutex> lock(mutex);
+    waiting.store(true);
+    bool result = predicate();
+    while(!result)
+    {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if(now >= deadline)
+            break;
+
+        std::chrono::steady_clock::time_point wake_time = deadline;
+        if(polling && deadline - now > producer_poll_interval)
+            wake_time = now + producer_poll_interval;
+        if(wake_time == std::chrono::steady_clock::time_point::max())
+            condition.wait(lock);
+        else
+            condition.wait_until(lock, wake_time);
+        result = predicate();
+    }
+    waiting.store(false);
+    return result;
+}
+
+void pcm_ring_buffer::wake(std::atomic<bool>& waiting)
+{
+    if(!waiting.load())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    condition.notify_all();
+}
+
+void pcm_ring_buffer::try_wake(std::atomic<bool>& waiting)
+{
+    if(!waiting.load())
+        return;
+
+    /// Taking the mutex orders this wakeup after the sleeper's last check. If it is busy, the sleeper finds the data at its next poll
+    if(mutex.try_lock())
+        mutex.unlock();
+    condition.notify_all();
+}
+
+std::size_t pcm_ring_buffer::wait_for_frames(std::size_t count, std::chrono::steady_clock::time_point deadline)
+{
+    const std::size_t frames_to_wait = std::min(std::max<std::size_t>(count, 1), capacity());
+    wait_until(consumer_waiting, deadline, [this, frames_to_wait] {
+        return size() >= frames_to_wait || finished.load();
+    });
+    return size();
+}
+
+bool pcm_ring_buffer::wait_for_drain(std::chrono::milliseconds timeout)
+{
+    return wait_until(producer_waiting, std::chrono::steady_clock::now() + timeout, [this] {
+        return is_drained() || cancelled.load();
+    });
+}
+
+void pcm_ring_buffer::finish()
+{
+    finished.store(true);
+    wake(consumer_waiting);
+    wake(producer_waiting);
+}
+
+void pcm_ring_buffer::cancel()
+{
+    cancelled.store(true);
+    finished.store(true);
+    wake(consumer_waiting);
+    wake(producer_waiting);
+}
+
+bool pcm_ring_buffer::is_finished() const
+{
+    return finished.load();
+}
+
+bool pcm_ring_buffer::is_cancelled() const
+{
+    return cancelled.load();
+}
+
+bool pcm_ring_buffer::is_drained() const
+{
+    return finished.load() && size() == 0;
+}
+
+std::size_t pcm_ring_buffer::size() const
+{
+    return write_index.load(std::memory_order_acquire) - read_index.load(std::memory_order_acquire);
+}
+
+std::size_t pcm_ring_buffer::capacity() const
+{
+    return mask + 1;
+}
@@ -0,0 +1,97 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHPCMRingBuffer_h
+#define RHPCMRingBuffer_h
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+namespace RHVoice {
+
+/// Single-producer/single-consumer lock-free FIFO of 16 bit PCM samples.
+/// Producer is the synthesis thread, consumer is the audio render callback.
+/// Data path never locks or allocates. The mutex is only taken by a side that has to sleep
+/// (producer on a full buffer, waiters for data) and by the producer when it sees a sleeper.
+/// Consumer only tries the mutex to wake the producer, so the producer also polls while it sleeps.
+class pcm_ring_buffer
+{
+public:
+    /// Capacity is rounded up to the next power of two.
+    explicit pcm_ring_buffer(std::size_t capacity);
+
+    /// Producer. Blocks while the buffer is full. Returns false if the buffer was cancelled.
+    bool write(const short* samples, std::size_t count);
+    /// Producer. Never blocks. Returns number of queued samples.
+    std::size_t try_write(const short* samples, std::size_t count);
+
+    /// Consumer. Never blocks. Returns number of samples copied into `samples`.
+    std::size_t read(short* samples, std::size_t count);
+    /// Consumer. Never blocks. Converts samples to float32 in [-1, 1) while copying them out.
+    std::size_t read(float* frames, std::size_t count);
+
+    /// Sleeps until at least `count` samples are available, the stream is finished or `deadline` passed.
+    /// Returns number of available samples, so caller does not need to poll.
+    std::size_t wait_for_frames(std::size_t count, std::chrono::steady_clock::time_point deadline);
+    /// Waits until consumer has read everything after `finish` or timeout expired.
+    bool wait_for_drain(std::chrono::milliseconds timeout);
+
+    void finish();
+    void cancel();
+
+    bool is_finished() const;
+    bool is_cancelled() const;
+    bool is_drained() const;
+    std::size_t size() const;
+    std::size_t capacity() const;
+
+private:
+    pcm_ring_buffer(const pcm_ring_buffer&);
+    pcm_ring_buffer& operator=(const pcm_ring_buffer&);
+
+    template<typename T, typename Convert>
+    std::size_t read_converted(T* output, std::size_t count, Convert convert);
+    template<typename Predicate>
+    bool wait_until(std::atomic<bool>& waiting, std::chrono::steady_clock::time_point deadline, Predicate predicate);
+    void wake(std::atomic<bool>& waiting);
+    /// Never blocks, for the render thread
+    void try_wake(std::atomic<bool>& waiting);
+
+    const std::size_t mask;
+    std::unique_ptr<short[]> buffer;
+
+    std::atomic<std::size_t> write_index;
+    std::atomic<std::size_t> read_index;
+    std::atomic<bool> finished;
+    std::atomic<bool> cancelled;
+
+    std::atomic<bool> producer_waiting;
+    std::atomic<bool> consumer_waiting;
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+}
+#endif /* RHPCMRingBuffer_h */
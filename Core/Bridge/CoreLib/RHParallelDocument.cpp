@@ -0,0 +1,319 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHParallelDocument.h"
+#include "RHCancellableClient.h"
+#include "RHTrace.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <thread>
+
+using namespace RHVoice;
+
+recording_client::recording_client(event_mask events, unsigned int audio_buffer_size, const std::atomic<bool>& cancelled):
+    events(events),
+    audio_buffer_size(audio_buffer_size),
+    cancelled(cancelled)
+{
+}
+
+event_mask recording_client::get_supported_events() const
+{
+    return events & (event_audio | event_word_starts | event_sentence_starts);
+}
+
+unsigned int recording_client::get_audio_buffer_size() const
+{
+    return audio_buffer_size;
+}
+
+bool recording_client::play_speech(const short* data,std::size_t count)
+{
+    if(cancelled)
+        return false;
+
+    event item = {event_type_audio, samples.size(), count};
+    recorded_events.push_back(item);
+    samples.insert(samples.end(), data, data + count);
+    return true;
+}
+
+bool recording_client::word_starts(std::size_t position,std::size_t length)
+{
+    event item = {event_type_word, position, length};
+    recorded_events.push_back(item);
+    return !cancelled;
+}
+
+bool recording_client::sentence_starts(std::size_t position,std::size_t length)
+{
+    event item = {event_type_sentence, position, length};
+    recorded_events.push_back(item);
+    return !cancelled;
+}
+
+bool recording_client::replay(client& target, std::size_t position_offset) const
+{
+    const event_mask target_events = target.get_supported_events();
+    for(std::vector<event>::const_iterator it = recorded_events.begin(); it != recorded_events.end(); ++it)
+    {
+        bool result = true;
+        switch(it->type)
+        {
+            case event_type_audio:
+                result = target.play_speech(samples.data() + it->first, it->second);
+                break;
+            case event_type_word:
+                if(target_events & event_word_starts)
+                    result = target.word_starts(it->first + position_offset, it->second);
+                break;
+            case event_type_sentence:
+                if(target_events & event_sentence_starts)
+                    result = target.sentence_starts(it->first + position_offset, it->second);
+                break;
+        }
+        if(!result)
+            return false;
+    }
+    return true;
+}
+
+std::size_t recording_client::sample_count() const
+{
+    return samples.size();
+}
+
+std::size_t recording_client::memory_size() const
+{
+    return samples.size() * sizeof(short) + recorded_events.size() * sizeof(event);
+}
+
+void recording_client::save(std::ostream& stream) const
+{
+    const std::uint64_t event_count = recorded_events.size();
+    const std::uint64_t samples_count = samples.size();
+    stream.write(reinterpret_cast<const char*>(&event_count), sizeof(event_count));
+    stream.write(reinterpret_cast<const char*>(&samples_count), sizeof(samples_count));
+    for(std::vector<event>::const_iterator it = recorded_events.begin(); it != recorded_events.end(); ++it)
+    {
+        const std::uint64_t fields[3] = {static_cast<std::uint64_t>(it->type), it->first, it->second};
+        stream.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+    }
+    stream.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(short));
+}
+
+bool recording_client::load(std::istream& stream)
+{
+    std::uint64_t event_count = 0;
+    std::uint64_t samples_count = 0;
+    stream.read(reinterpret_cast<char*>(&event_count), sizeof(event_count));
+    stream.read(reinterpret_cast<char*>(&samples_count), sizeof(samples_count));
+    if(!stream)
+        return false;
+
+    std::vector<event> loaded_events;
+    loaded_events.reserve(event_count);
+    for(std::uint64_t i = 0; i < event_count; ++i)
+    {
+        std::uint64_t fields[3];
+        if(!stream.read(reinterpret_cast<char*>(fields), sizeof(fields)) || fields[0] > event_type_sentence)
+            return false;
+        if(fields[0] == event_type_audio && fields[1] + fields[2] > samples_count)
+            return false;
+        event item = {static_cast<event_type>(fields[0]), static_cast<std::size_t>(fields[1]), static_cast<std::size_t>(fields[2])};
+        loaded_events.push_back(item);
+    }
+
+    std::vector<short> loaded_samples(samples_count);
+    if(!stream.read(reinterpret_cast<char*>(loaded_samples.data()), samples_count * sizeof(short)))
+        return false;
+
+    recorded_events.swap(loaded_events);
+    samples.swap(loaded_samples);
+    return true;
+}
+
+parallel_document_settings::parallel_document_settings():
+    rate(1.0),
+    volume(1.0),
+    quality("standard"),
+    thread_count(std::max(1u, std::thread::hardware_concurrency())),
+    min_piece_size(256),
+    position_offset(0),
+    cancellation(nullptr)
+{
+}
+
+parallel_document::parallel_document(const std::shared_ptr<engine>& engine, const char* text, std::size_t text_size, const parallel_document_settings& settings):
+    engine_ptr(engine),
+    text(text),
+    text_size(text_size),
+    settings(settings),
+    owner(nullptr),
+    owner_events(0),
+    owner_audio_buffer_size(0),
+    next_piece(0),
+    next_to_replay(0),
+    cancelled(false)
+{
+    const std::vector<text_range> ranges = split_sentences(text, text_size, settings.min_piece_size);
+    pieces.resize(ranges.size());
+    for(std::size_t index = 0; index < ranges.size(); ++index)
+        pieces[index].range = ranges[index];
+}
+
+void parallel_document::set_owner(client& owner)
+{
+    this->owner = &owner;
+}
+
+std::size_t parallel_document::piece_count() const
+{
+    return pieces.size();
+}
+
+void parallel_document::synthesize_piece(piece& item)
+{
+    RH_TRACE_SPAN("parallel.piece");
+    item.recording.reset(new recording_client(owner_events, owner_audio_buffer_size, cancelled));
+
+    const char* const begin = text + item.range.begin;
+    const char* const end = text + item.range.end;
+    std::unique_ptr<document> doc = document::create_from_plain_text(engine_ptr, begin, end, content_text, settings.profile);
+    doc->speech_settings.relative.rate = settings.rate;
+    doc->speech_settings.relative.volume = settings.volume;
+    doc->quality.set_from_string(settings.quality);
+    if(settings.cancellation == nullptr)
+    {
+        doc->set_owner(*item.recording);
+        doc->synthesize();
+        return;
+    }
+
+    cancellable_client owner(*item.recording, *settings.cancellation);
+    doc->set_owner(owner);
+    doc->synthesize();
+}
+
+bool parallel_document::is_cancelled_by_caller() const
+{
+    return settings.cancellation != nullptr && *settings.cancellation;
+}
+
+void parallel_document::work()
+{
+    /// Pieces are only taken this far ahead of playback, so memory does not grow with the text length
+    const std::size_t lookahead = settings.thread_count * 2;
+    while(true)
+    {
+        std::size_t index = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            replay_progress.wait(lock, [this, lookahead] {
+                return cancelled || next_piece >= pieces.size() || next_piece < next_to_replay + lookahead;
+            });
+            if(is_cancelled_by_caller())
+                cancelled = true;
+            if(cancelled || next_piece >= pieces.size())
+                return;
+            index = next_piece++;
+        }
+
+        try
+        {
+            synthesize_piece(pieces[index]);
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(!error)
+                error = std::current_exception();
+            cancelled = true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pieces[index].ready = true;
+            if(is_cancelled_by_caller())
+                cancelled = true;
+        }
+        piece_ready.notify_all();
+    }
+}
+
+void parallel_document::synthesize()
+{
+    if(owner == nullptr)
+        return;
+
+    owner_events = owner->get_supported_events();
+    owner_audio_buffer_size = owner->get_audio_buffer_size();
+
+    const std::size_t thread_count = std::max<std::size_t>(1, std::min(settings.thread_count, pieces.size()));
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count);
+    for(std::size_t index = 0; index < thread_count; ++index)
+        workers.push_back(std::thread(&parallel_document::work, this));
+
+    for(std::size_t index = 0; index < pieces.size(); ++index)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            piece_ready.wait(lock, [this, index] { return pieces[index].ready || cancelled; });
+            if(is_cancelled_by_caller())
+                cancelled = true;
+            if(cancelled)
+                break;
+        }
+
+        bool replayed = false;
+        {
+            RH_TRACE_SPAN("parallel.replay");
+            replayed = pieces[index].recording->replay(*owner, settings.position_offset + pieces[index].range.begin);
+        }
+        pieces[index].recording.reset();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            next_to_replay = index + 1;
+            if(!replayed)
+                cancelled = true;
+        }
+        replay_progress.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(next_to_replay < pieces.size())
+            cancelled = true;
+    }
+    replay_progress.notify_all();
+    for(std::vector<std::thread>::iterator it = workers.begin(); it != workers.end(); ++it)
+        it->join();
+
+    if(error)
+        std::rethrow_exception(error);
+    if(!cancelled)
+        owner->done();
+}
@@ -0,0 +1,154 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHParallelDocument_h
+#define RHParallelDocument_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/engine.hpp"
+#include "core/document.hpp"
+#include "core/client.hpp"
+
+#include "RHSentenceSplitter.h"
+
+namespace RHVoice {
+
+/// Client that keeps audio and marker events in the order engine produced them,
+/// so they can be replayed later into another client.
+class recording_client: public RHVoice::client
+{
+public:
+    recording_client(event_mask events, unsigned int audio_buffer_size, const std::atomic<bool>& cancelled);
+    event_mask get_supported_events() const override;
+    unsigned int get_audio_buffer_size() const override;
+    bool play_speech(const short* samples,std::size_t count) override;
+    bool word_starts(std::size_t position,std::size_t length) override;
+    bool sentence_starts(std::size_t position,std::size_t length) override;
+
+    /// Replays recorded audio and the marker events the target supports. Marker positions are shifted by `position_offset`.
+    /// Returns false as soon as `target` asks to stop.
+    bool replay(client& target, std::size_t position_offset) const;
+    std::size_t sample_count() const;
+    /// Bytes used by recorded samples and events
+    std::size_t memory_size() const;
+
+    void save(std::ostream& stream) const;
+    /// Replaces recorded events with ones written by `save`. Returns false if data is malformed.
+    bool load(std::istream& stream);
+
+private:
+    enum event_type
+    {
+        event_type_audio,
+        event_type_word,
+        event_type_sentence
+    };
+
+    struct event
+    {
+        event_type type;
+        std::size_t first;
+        std::size_t second;
+    };
+
+    const event_mask events;
+    const unsigned int audio_buffer_size;
+    const std::atomic<bool>& cancelled;
+    std::vector<event> recorded_events;
+    std::vector<short> samples;
+};
+
+struct parallel_document_settings
+{
+    parallel_document_settings();
+
+    voice_profile profile;
+    double rate;
+    double volume;
+    std::string quality;
+    std::size_t thread_count;
+    /// Pieces smaller than this are merged with the following sentences
+    std::size_t min_piece_size;
+    /// Added to marker positions, e.g. to map them back to SSML the text was wrapped in
+    std::size_t position_offset;
+    /// When set, workers stop at the next word or audio chunk after it becomes true. Has to outlive the document
+    const std::atomic<bool>* cancellation;
+};
+
+/// Splits plain text at sentence boundaries and synthesizes pieces on a pool of worker threads.
+/// Each worker creates its own `document` per piece. Audio and markers are delivered to the owner
+/// strictly in text order, as soon as the next piece is ready, with the same positions a single
+/// document would report.
+class parallel_document
+{
+public:
+    /// UTF-8 `text` is not copied and has to outlive the document.
+    parallel_document(const std::shared_ptr<engine>& engine, const char* text, std::size_t text_size, const parallel_document_settings& settings);
+
+    void set_owner(client& owner);
+    /// Throws the first exception raised by a worker, same as `document::synthesize`.
+    void synthesize();
+    std::size_t piece_count() const;
+
+private:
+    struct piece
+    {
+        piece(): ready(false) {}
+
+        text_range range;
+        std::unique_ptr<recording_client> recording;
+        bool ready;
+    };
+
+    void work();
+    bool is_cancelled_by_caller() const;
+    void synthesize_piece(piece& item);
+
+    std::shared_ptr<engine> engine_ptr;
+    const char* const text;
+    const std::size_t text_size;
+    parallel_document_settings settings;
+    client* owner;
+    event_mask owner_events;
+    unsigned int owner_audio_buffer_size;
+
+    std::vector<piece> pieces;
+    std::size_t next_piece;
+    std::size_t next_to_replay;
+    std::atomic<bool> cancelled;
+    std::exception_ptr error;
+
+    std::mutex mutex;
+    std::condition_variable piece_ready;
+    std::condition_variable replay_progress;
+};
+
+}
+#endif /* RHParallelDocument_h */
@@ -0,0 +1,237 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHSentenceSplitter.h"
+
+#include <cstdint>
+#include <cstring>
+
+using namespace RHVoice;
+
+namespace {
+
+bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+/// Length of sentence final punctuation at `position` or 0: . ! ? and the UTF-8 encoded … 。 ！ ？
+std::size_t terminator_length(const char* text, std::size_t size, std::size_t position)
+{
+    const char c = text[position];
+    if(c == '.' || c == '!' || c == '?')
+        return 1;
+
+    if(position + 3 > size)
+        return 0;
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text + position);
+    const bool ellipsis = bytes[0] == 0xE2 && bytes[1] == 0x80 && bytes[2] == 0xA6;
+    const bool ideographic_full_stop = bytes[0] == 0xE3 && bytes[1] == 0x80 && bytes[2] == 0x82;
+    const bool fullwidth_mark = bytes[0] == 0xEF && bytes[1] == 0xBC && (bytes[2] == 0x81 || bytes[2] == 0x9F);
+    return (ellipsis || ideographic_full_stop || fullwidth_mark) ? 3 : 0;
+}
+
+/// Decodes UTF-8 code point at `position`, returns 0 if it is malformed
+std::uint32_t code_point_at(const char* text, std::size_t size, std::size_t position)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text + position);
+    const std::size_t available = size - position;
+    if(bytes[0] < 0x80)
+        return bytes[0];
+
+    std::size_t length = 0;
+    std::uint32_t result = 0;
+    if((bytes[0] & 0xE0) == 0xC0)
+    {
+        length = 2;
+        result = bytes[0] & 0x1F;
+    }
+    else if((bytes[0] & 0xF0) == 0xE0)
+    {
+        length = 3;
+        result = bytes[0] & 0x0F;
+    }
+    else if((bytes[0] & 0xF8) == 0xF0)
+    {
+        length = 4;
+        result = bytes[0] & 0x07;
+    }
+    if(length == 0 || length > available)
+        return 0;
+
+    for(std::size_t index = 1; index < length; ++index)
+    {
+        if((bytes[index] & 0xC0) != 0x80)
+            return 0;
+        result = (result << 6) | (bytes[index] & 0x3F);
+    }
+    return result;
+}
+
+/// Lowercase letters of Latin, Greek and Cyrillic scripts
+bool is_lowercase(std::uint32_t c)
+{
+    if(c >= 'a' && c <= 'z')
+        return true;
+    if((c >= 0xDF && c <= 0xF6) || (c >= 0xF8 && c <= 0xFF))
+        return true;
+    /// Latin Extended-A alternates upper and lower case
+    if((c >= 0x100 && c <= 0x137) || (c >= 0x14A && c <= 0x177))
+        return c % 2 == 1;
+    if((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E))
+        return c % 2 == 0;
+    if(c == 0x138 || c == 0x149 || c == 0x17F)
+        return true;
+    if(c >= 0x3AC && c <= 0x3CE)
+        return true;
+    if(c >= 0x430 && c <= 0x45F)
+        return true;
+    /// Cyrillic extensions alternate upper and lower case as well
+    if((c >= 0x460 && c <= 0x481) || (c >= 0x48A && c <= 0x4BF) || (c >= 0x4D0 && c <= 0x52F))
+        return c % 2 == 1;
+    if(c >= 0x4C1 && c <= 0x4CE)
+        return c % 2 == 0;
+    return c == 0x4CF;
+}
+
+/// Abbreviations that are usually followed by a capitalized name
+const char* const name_abbreviations[] = {
+    "ул", "пр", "пер", "пл", "просп", "им", "св", "ст", "проф", "акад", "доц", "тов", "гр", "обл", "р", "оз",
+    "Mr", "Mrs", "Ms", "Dr", "St", "Prof", "Mt", "Jr", "Sr"
+};
+
+bool is_word_byte(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (static_cast<unsigned char>(c) & 0x80) != 0;
+}
+
+/// Word right before the full stop at `position` is an initial, like "А. С. Пушкин", or a known abbreviation
+bool is_abbreviation_before(const char* text, std::size_t size, std::size_t position)
+{
+    std::size_t begin = position;
+    while(begin > 0 && is_word_byte(text[begin - 1]))
+        --begin;
+    if(begin == position)
+        return false;
+
+    const std::size_t length = position - begin;
+    const std::uint32_t first = code_point_at(text, size, begin);
+    const bool single_letter = first < 0x80 ? length == 1 : (first < 0x800 ? length == 2 : false);
+    if(single_letter)
+        return true;
+
+    for(std::size_t index = 0; index < sizeof(name_abbreviations) / sizeof(name_abbreviations[0]); ++index)
+    {
+        if(std::strlen(name_abbreviations[index]) == length && std::memcmp(name_abbreviations[index], text + begin, length) == 0)
+            return true;
+    }
+    return false;
+}
+
+/// If a sentence ends at `position`, returns where the next one starts (after trailing spaces), otherwise 0.
+std::size_t sentence_end_at(const char* text, std::size_t size, std::size_t position)
+{
+    if(text[position] == '\n')
+    {
+        std::size_t next = position + 1;
+        while(next < size && is_space(text[next]))
+            ++next;
+        return next;
+    }
+
+    std::size_t length = terminator_length(text, size, position);
+    if(length == 0)
+        return 0;
+
+    const bool is_full_stop = length == 1 && text[position] == '.';
+    std::size_t next = position + length;
+    while(next < size && terminator_length(text, size, next) != 0)
+        next += terminator_length(text, size, next);
+    while(next < size && (text[next] == '"' || text[next] == '\'' || text[next] == ')'))
+        ++next;
+
+    if(next >= size || !is_space(text[next]))
+        return 0;
+
+    while(next < size && is_space(text[next]))
+        ++next;
+
+    /// "e.g. this", "т.е. это", "2024 г. в" and "ул. Ленина" are not sentence boundaries
+    if(is_full_stop && next < size && (is_lowercase(code_point_at(text, size, next)) || is_abbreviation_before(text, size, position)))
+        return 0;
+    return next;
+}
+
+}
+
+namespace RHVoice {
+
+std::vector<text_range> split_sentences(const char* text, std::size_t size, std::size_t min_piece_size)
+{
+    std::vector<text_range> result;
+    std::size_t piece_begin = 0;
+    std::size_t position = 0;
+    while(position < size)
+    {
+        const std::size_t next = sentence_end_at(text, size, position);
+        if(next == 0)
+        {
+            ++position;
+            continue;
+        }
+
+        if(next - piece_begin >= min_piece_size && next < size)
+        {
+            text_range range = {piece_begin, next};
+            result.push_back(range);
+            piece_begin = next;
+        }
+        position = next;
+    }
+
+    if(piece_begin < size)
+    {
+        text_range range = {piece_begin, size};
+        result.push_back(range);
+    }
+    return result;
+}
+
+std::size_t find_last_sentence_end(const char* text, std::size_t size)
+{
+    std::size_t result = 0;
+    std::size_t position = 0;
+    while(position < size)
+    {
+        const std::size_t next = sentence_end_at(text, size, position);
+        if(next == 0 || next >= size)
+        {
+            ++position;
+            continue;
+        }
+        result = next;
+        position = next;
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,47 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHSentenceSplitter_h
+#define RHSentenceSplitter_h
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace RHVoice {
+
+struct text_range
+{
+    std::size_t begin;
+    std::size_t end;
+};
+
+/// Splits UTF-8 plain text after sentence final punctuation followed by a space and at line breaks.
+/// Adjacent sentences are merged until a piece is at least `min_piece_size` bytes long.
+/// Returned ranges are contiguous and cover the whole text, so offsets can be mapped back.
+std::vector<text_range> split_sentences(const char* text, std::size_t size, std::size_t min_piece_size);
+
+/// Position right after the last complete sentence in `text`, or 0 if there is none.
+/// Used when text arrives in chunks and the tail can still grow.
+std::size_t find_last_sentence_end(const char* text, std::size_t size);
+
+}
+#endif /* RHSentenceSplitter_h */
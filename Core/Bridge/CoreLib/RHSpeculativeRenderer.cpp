@@ -0,0 +1,157 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHSpeculativeRenderer.h"
+
+#include <vector>
+
+#include "RHCancellableClient.h"
+#include "RHTrace.h"
+
+namespace RHVoice {
+
+namespace {
+
+/// Accepts everything, so `caching_client` records the whole utterance
+class discarding_client: public client
+{
+public:
+    event_mask get_supported_events() const override
+    {
+        return event_audio | event_done;
+    }
+
+    bool play_speech(const short*,std::size_t) override
+    {
+        return true;
+    }
+};
+
+}
+
+speculative_renderer::speculative_renderer(std::size_t max_pending):
+    max_pending(max_pending)
+{
+    stats.enqueued = 0;
+    stats.completed = 0;
+    stats.dropped = 0;
+    stats.joined = 0;
+}
+
+bool speculative_renderer::enqueue(const std::shared_ptr<utterance_cache>& cache, const std::string& key, const render_function& render)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(entries.size() >= max_pending || entries.count(key) != 0)
+        return false;
+
+    entry& item = entries[key];
+    item.running = false;
+    ++stats.enqueued;
+
+    item.identifier = scheduler.submit(utterance_priority_background, [this, cache, key, render](const std::atomic<bool>& cancelled) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(cancelled)
+            {
+                entries.erase(key);
+                ++stats.dropped;
+                finished.notify_all();
+                return;
+            }
+            entries[key].running = true;
+        }
+
+        discarding_client sink;
+        caching_client cachingClient(sink, *cache, key);
+        cancellable_client owner(cachingClient, cancelled);
+        bool rendered = true;
+        try
+        {
+            RH_TRACE_SPAN("speculative.render");
+            render(owner);
+        }
+        catch(...)
+        {
+            rendered = false;
+        }
+        finish(key, rendered && !cancelled);
+    }, utterance_scheduler::cancel_function());
+    return true;
+}
+
+void speculative_renderer::drop_all_except(const std::string& key)
+{
+    std::vector<utterance_scheduler::task_id> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(std::map<std::string, entry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+        {
+            if(it->first != key || !it->second.running)
+                dropped.push_back(it->second.identifier);
+        }
+    }
+
+    for(std::vector<utterance_scheduler::task_id>::const_iterator it = dropped.begin(); it != dropped.end(); ++it)
+        scheduler.cancel(*it);
+}
+
+void speculative_renderer::join(const std::string& key)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    std::map<std::string, entry>::const_iterator item = entries.find(key);
+    if(item == entries.end() || !item->second.running)
+        return;
+
+    ++stats.joined;
+    finished.wait(lock, [this, &key]() {
+        return entries.count(key) == 0;
+    });
+}
+
+void speculative_renderer::cancel_all()
+{
+    scheduler.cancel_all();
+}
+
+bool speculative_renderer::empty() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.empty();
+}
+
+speculative_renderer::statistics speculative_renderer::get_statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void speculative_renderer::finish(const std::string& key, bool completed)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.erase(key);
+    if(completed)
+        ++stats.completed;
+    else
+        ++stats.dropped;
+    finished.notify_all();
+}
+
+}
@@ -0,0 +1,92 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHSpeculativeRenderer_h
+#define RHSpeculativeRenderer_h
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "core/client.hpp"
+
+#include "RHPCMCache.h"
+#include "RHUtteranceScheduler.h"
+
+namespace RHVoice {
+
+/// Renders utterances that are likely to be requested next into `utterance_cache` on its own low priority thread,
+/// so a matching request is replayed from cache instead of waiting for engine.
+class speculative_renderer
+{
+public:
+    /// Has to synthesize the utterance into `owner`. Called on renderer thread.
+    typedef std::function<void(client& owner)> render_function;
+
+    struct statistics
+    {
+        std::uint64_t enqueued;
+        std::uint64_t completed;
+        /// Cancelled because something else was requested, or by `cancel_all`
+        std::uint64_t dropped;
+        /// Requested while still rendering, so the request waited for it
+        std::uint64_t joined;
+    };
+
+    /// At most `max_pending` utterances are queued or rendering at the same time
+    explicit speculative_renderer(std::size_t max_pending);
+
+    /// Returns false if `key` is already queued or the queue is full
+    bool enqueue(const std::shared_ptr<utterance_cache>& cache, const std::string& key, const render_function& render);
+    /// Has to be called when `key` is requested for real. Drops everything except `key` if it is rendering now
+    void drop_all_except(const std::string& key);
+    /// Has to be called before looking `key` up in cache. Waits until `key` is rendered if it is rendering now
+    void join(const std::string& key);
+    void cancel_all();
+    bool empty() const;
+    statistics get_statistics() const;
+
+private:
+    struct entry
+    {
+        utterance_scheduler::task_id identifier;
+        bool running;
+    };
+
+    void finish(const std::string& key, bool completed);
+
+    const std::size_t max_pending;
+
+    mutable std::mutex mutex;
+    std::condition_variable finished;
+    std::map<std::string, entry> entries;
+    statistics stats;
+    /// Destroyed first, its cancelled tasks still use members above
+    utterance_scheduler scheduler;
+};
+
+}
+#endif /* RHSpeculativeRenderer_h */
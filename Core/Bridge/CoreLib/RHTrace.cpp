@@ -0,0 +1,294 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHTrace.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace RHVoice {
+namespace trace {
+
+std::atomic<bool> enabled_flag(false);
+
+namespace {
+
+/// Enough for a few minutes of speech with spans around every engine callback
+const std::size_t events_per_chunk = 1 << 10;
+const std::size_t chunks_per_thread = 16;
+
+struct event
+{
+    const char* name;
+    std::uint64_t begin;
+    /// Equal to `begin` for instant events
+    std::uint64_t end;
+};
+
+/// Written only by its thread. `count` is published after the event, so readers never see a half written event.
+/// Events are allocated in chunks when they are needed, so threads that record few spans stay cheap.
+struct thread_buffer
+{
+    thread_buffer():
+        thread_id(0),
+        epoch(0),
+        count(0),
+        dropped(0),
+        finished(false)
+    {
+    }
+
+    event& at(std::size_t index)
+    {
+        return chunks[index / events_per_chunk][index % events_per_chunk];
+    }
+
+    std::size_t thread_id;
+    std::unique_ptr<event[]> chunks[chunks_per_thread];
+    /// Buffer holds events of this `clear` generation. Owner thread resets it when generation changes
+    std::atomic<std::uint64_t> epoch;
+    std::atomic<std::size_t> count;
+    std::atomic<std::uint64_t> dropped;
+    /// Set under registry mutex when thread exits
+    bool finished;
+};
+
+struct registry
+{
+    registry(): next_thread_id(1), epoch(0) {}
+
+    std::mutex mutex;
+    std::size_t next_thread_id;
+    std::atomic<std::uint64_t> epoch;
+    /// Buffers of finished threads are kept until `clear`, so their spans are still written
+    std::vector<std::shared_ptr<thread_buffer>> buffers;
+    /// Buffers of finished threads, with their chunks, for threads started later
+    std::vector<std::shared_ptr<thread_buffer>> free_buffers;
+};
+
+registry& shared_registry()
+{
+    static registry* instance = new registry();
+    return *instance;
+}
+
+bool is_current(const thread_buffer& buffer, std::uint64_t epoch)
+{
+    return buffer.epoch.load(std::memory_order_acquire) == epoch;
+}
+
+void recycle(registry& shared, const std::shared_ptr<thread_buffer>& buffer)
+{
+    buffer->count.store(0, std::memory_order_relaxed);
+    buffer->dropped.store(0, std::memory_order_relaxed);
+    shared.free_buffers.push_back(buffer);
+}
+
+/// Gives buffer back to registry when its thread exits
+struct buffer_owner
+{
+    ~buffer_owner()
+    {
+        if(!buffer)
+            return;
+
+        registry& shared = shared_registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        buffer->finished = true;
+        if(buffer->count.load(std::memory_order_relaxed) != 0 && is_current(*buffer, shared.epoch.load()))
+            return;
+
+        for(std::vector<std::shared_ptr<thread_buffer>>::iterator it = shared.buffers.begin(); it != shared.buffers.end(); ++it)
+        {
+            if(*it == buffer)
+            {
+                shared.buffers.erase(it);
+                break;
+            }
+        }
+        recycle(shared, buffer);
+    }
+
+    std::shared_ptr<thread_buffer> buffer;
+};
+
+thread_buffer& current_buffer()
+{
+    static thread_local buffer_owner owner;
+    if(!owner.buffer)
+    {
+        registry& shared = shared_registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        if(shared.free_buffers.empty())
+        {
+            owner.buffer = std::make_shared<thread_buffer>();
+        }
+        else
+        {
+            owner.buffer = shared.free_buffers.back();
+            shared.free_buffers.pop_back();
+        }
+        owner.buffer->thread_id = shared.next_thread_id++;
+        owner.buffer->finished = false;
+        owner.buffer->epoch.store(shared.epoch.load(), std::memory_order_release);
+        shared.buffers.push_back(owner.buffer);
+    }
+    return *owner.buffer;
+}
+
+void append(const char* name, std::uint64_t begin, std::uint64_t end)
+{
+    thread_buffer& buffer = current_buffer();
+    const std::uint64_t epoch = shared_registry().epoch.load(std::memory_order_acquire);
+    if(buffer.epoch.load(std::memory_order_relaxed) != epoch)
+    {
+        /// Buffer was cleared. Readers ignore it until the new epoch is published
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        buffer.epoch.store(epoch, std::memory_order_release);
+    }
+
+    const std::size_t index = buffer.count.load(std::memory_order_relaxed);
+    if(index >= events_per_chunk * chunks_per_thread)
+    {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::unique_ptr<event[]>& chunk = buffer.chunks[index / events_per_chunk];
+    if(!chunk)
+        chunk.reset(new event[events_per_chunk]);
+
+    event& item = buffer.at(index);
+    item.name = name;
+    item.begin = begin;
+    item.end = end;
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void write_microseconds(std::ostream& stream, std::uint64_t nanoseconds)
+{
+    stream << nanoseconds / 1000 << '.';
+    const std::uint64_t fraction = nanoseconds % 1000;
+    if(fraction < 100)
+        stream << '0';
+    if(fraction < 10)
+        stream << '0';
+    stream << fraction;
+}
+
+}
+
+void set_enabled(bool enabled)
+{
+    enabled_flag.store(enabled, std::memory_order_relaxed);
+}
+
+void clear()
+{
+    registry& shared = shared_registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    /// Live buffers are reset by their own threads, finished ones are recycled right away
+    shared.epoch.fetch_add(1);
+    std::vector<std::shared_ptr<thread_buffer>> alive;
+    for(std::vector<std::shared_ptr<thread_buffer>>::iterator it = shared.buffers.begin(); it != shared.buffers.end(); ++it)
+    {
+        if((*it)->finished)
+            recycle(shared, *it);
+        else
+            alive.push_back(*it);
+    }
+    shared.buffers.swap(alive);
+}
+
+std::uint64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void record(const char* name, std::uint64_t begin, std::uint64_t end)
+{
+    append(name, begin, end);
+}
+
+void instant(const char* name)
+{
+    const std::uint64_t timestamp = now();
+    append(name, timestamp, timestamp);
+}
+
+void write_chrome_trace(std::ostream& stream)
+{
+    registry& shared = shared_registry();
+    /// Keeps finished threads from recycling their buffers and `clear` from starting a new epoch while writing
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    const std::uint64_t epoch = shared.epoch.load();
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for(std::vector<std::shared_ptr<thread_buffer>>::const_iterator buffer = shared.buffers.begin(); buffer != shared.buffers.end(); ++buffer)
+    {
+        if(!is_current(**buffer, epoch))
+            continue;
+
+        const std::size_t count = (*buffer)->count.load(std::memory_order_acquire);
+        for(std::size_t index = 0; index < count; ++index)
+        {
+            const event& item = (*buffer)->at(index);
+            if(!first)
+                stream << ',';
+            first = false;
+            /// Names are literals from this code base, they need no escaping
+            stream << "\n{\"name\":\"" << item.name << "\",\"cat\":\"RHVoice\",\"pid\":1,\"tid\":" << (*buffer)->thread_id << ",\"ts\":";
+            write_microseconds(stream, item.begin);
+            if(item.end == item.begin)
+            {
+                stream << ",\"ph\":\"i\",\"s\":\"t\"}";
+            }
+            else
+            {
+                stream << ",\"ph\":\"X\",\"dur\":";
+                write_microseconds(stream, item.end - item.begin);
+                stream << '}';
+            }
+        }
+    }
+    stream << "\n]}\n";
+}
+
+std::uint64_t dropped_count()
+{
+    registry& shared = shared_registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    const std::uint64_t epoch = shared.epoch.load();
+    std::uint64_t dropped = 0;
+    for(std::vector<std::shared_ptr<thread_buffer>>::const_iterator it = shared.buffers.begin(); it != shared.buffers.end(); ++it)
+    {
+        if(is_current(**it, epoch))
+            dropped += (*it)->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+}
+}
@@ -0,0 +1,94 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHTrace_h
+#define RHTrace_h
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+
+namespace RHVoice {
+namespace trace {
+
+/// Tracing is off by default. While it is off a span costs one relaxed atomic load.
+/// While it is on a span costs two clock reads and a write into a buffer owned by the calling thread,
+/// no locks are taken except when a thread records its first span and when it exits.
+/// Buffers of exited threads are reused by new ones, so short lived threads do not add up.
+extern std::atomic<bool> enabled_flag;
+
+inline bool is_enabled()
+{
+    return enabled_flag.load(std::memory_order_relaxed);
+}
+
+void set_enabled(bool enabled);
+/// Drops recorded events. Threads that are recording at the moment drop theirs before the next event.
+void clear();
+/// Nanoseconds from a monotonic clock
+std::uint64_t now();
+/// `name` has to be a string literal, it is stored as a pointer
+void record(const char* name, std::uint64_t begin, std::uint64_t end);
+void instant(const char* name);
+/// Chrome trace event format, can be opened in Perfetto or chrome://tracing.
+/// Spans recorded while writing may be missing from output.
+void write_chrome_trace(std::ostream& stream);
+/// Events that did not fit into thread buffers
+std::uint64_t dropped_count();
+
+class span
+{
+public:
+    explicit span(const char* name):
+        name(name),
+        begin(is_enabled() ? now() : 0)
+    {
+    }
+
+    ~span()
+    {
+        if(begin != 0)
+            record(name, begin, now());
+    }
+
+private:
+    span(const span&);
+    span& operator=(const span&);
+
+    const char* const name;
+    const std::uint64_t begin;
+};
+
+}
+}
+
+#define RH_TRACE_CONCAT_IMPL(a, b) a##b
+#define RH_TRACE_CONCAT(a, b) RH_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef RHVOICE_DISABLE_TRACING
+#define RH_TRACE_SPAN(name)
+#define RH_TRACE_INSTANT(name)
+#else
+#define RH_TRACE_SPAN(name) RHVoice::trace::span RH_TRACE_CONCAT(rh_trace_span_, __LINE__)(name)
+#define RH_TRACE_INSTANT(name) if(RHVoice::trace::is_enabled()) RHVoice::trace::instant(name)
+#endif
+
+#endif /* RHTrace_h */
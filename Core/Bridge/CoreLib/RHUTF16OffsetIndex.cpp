@@ -0,0 +1,191 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+
+#include "RHUTF16OffsetIndex.h"
+
+#include <algorithm>
+
+using namespace RHVoice;
+
+namespace
+{
+    bool is_continuation_byte(unsigned char byte)
+    {
+        return (byte & 0xC0) == 0x80;
+    }
+
+    std::size_t sequence_size(unsigned char lead)
+    {
+        if(lead < 0x80)
+            return 1;
+        if((lead & 0xE0) == 0xC0)
+            return 2;
+        if((lead & 0xF0) == 0xE0)
+            return 3;
+        if((lead & 0xF8) == 0xF0)
+            return 4;
+        /// Malformed byte, NSString replaces it with a single character
+        return 1;
+    }
+
+    std::size_t utf16_units(std::size_t utf8_sequence_size)
+    {
+        return utf8_sequence_size == 4 ? 2 : 1;
+    }
+
+    bool is_zero_width_joiner(std::uint32_t code_point)
+    {
+        return code_point == 0x200D;
+    }
+
+    /// Code points that never start a visible character on their own
+    bool is_extending(std::uint32_t code_point)
+    {
+        return (code_point >= 0x0300 && code_point <= 0x036F) ||
+               (code_point >= 0x1AB0 && code_point <= 0x1AFF) ||
+               (code_point >= 0x1DC0 && code_point <= 0x1DFF) ||
+               (code_point >= 0x20D0 && code_point <= 0x20FF) ||
+               (code_point >= 0xFE00 && code_point <= 0xFE0F) ||
+               (code_point >= 0xFE20 && code_point <= 0xFE2F) ||
+               (code_point >= 0x1F3FB && code_point <= 0x1F3FF) ||
+               (code_point >= 0xE0020 && code_point <= 0xE007F) ||
+               (code_point >= 0xE0100 && code_point <= 0xE01EF) ||
+               is_zero_width_joiner(code_point);
+    }
+}
+
+utf16_offset_index::utf16_offset_index(const char* text, std::size_t text_size):
+    text(text),
+    text_size(text_size),
+    total_utf16_size(0)
+{
+    checkpoints.reserve(text_size / checkpoint_interval + 1);
+    std::size_t next_checkpoint = 0;
+    std::size_t offset = 0;
+    while(offset < text_size)
+    {
+        if(offset >= next_checkpoint)
+        {
+            checkpoint item = {static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(total_utf16_size)};
+            checkpoints.push_back(item);
+            next_checkpoint = offset + checkpoint_interval;
+        }
+        const std::size_t size = std::min(sequence_size(static_cast<unsigned char>(text[offset])), text_size - offset);
+        total_utf16_size += utf16_units(size);
+        offset += size;
+    }
+}
+
+std::size_t utf16_offset_index::utf16_size() const
+{
+    return total_utf16_size;
+}
+
+bool utf16_offset_index::utf16_offset(std::size_t utf8_offset, std::size_t& result) const
+{
+    if(utf8_offset > text_size)
+        return false;
+    if(utf8_offset == text_size)
+    {
+        result = total_utf16_size;
+        return true;
+    }
+    if(is_continuation_byte(static_cast<unsigned char>(text[utf8_offset])))
+        return false;
+
+    struct offset_less
+    {
+        bool operator()(std::size_t value, const checkpoint& item) const
+        {
+            return value < item.utf8_offset;
+        }
+    };
+    std::vector<checkpoint>::const_iterator found = std::upper_bound(checkpoints.begin(), checkpoints.end(), utf8_offset, offset_less());
+    if(found == checkpoints.begin())
+        return false;
+    --found;
+
+    std::size_t offset = found->utf8_offset;
+    std::size_t units = found->utf16_offset;
+    while(offset < utf8_offset)
+    {
+        const std::size_t size = std::min(sequence_size(static_cast<unsigned char>(text[offset])), text_size - offset);
+        units += utf16_units(size);
+        offset += size;
+    }
+    if(offset != utf8_offset)
+        return false;
+
+    result = units;
+    return true;
+}
+
+std::size_t utf16_offset_index::decode(std::size_t utf8_offset, std::uint32_t& code_point) const
+{
+    const unsigned char lead = static_cast<unsigned char>(text[utf8_offset]);
+    const std::size_t size = std::min(sequence_size(lead), text_size - utf8_offset);
+    static const unsigned char lead_masks[] = {0, 0x7F, 0x1F, 0x0F, 0x07};
+    code_point = lead & lead_masks[size];
+    for(std::size_t i = 1; i < size; ++i)
+        code_point = (code_point << 6) | (static_cast<unsigned char>(text[utf8_offset + i]) & 0x3F);
+    return size;
+}
+
+std::size_t utf16_offset_index::extend_to_character_end(std::size_t utf8_offset) const
+{
+    bool after_joiner = false;
+    while(utf8_offset < text_size)
+    {
+        std::uint32_t code_point = 0;
+        const std::size_t size = decode(utf8_offset, code_point);
+        if(!after_joiner && !is_extending(code_point))
+            break;
+        after_joiner = is_zero_width_joiner(code_point);
+        utf8_offset += size;
+    }
+    return utf8_offset;
+}
+
+bool utf16_offset_index::utf16_range(std::size_t utf8_location, std::size_t utf8_length,
+                                     std::size_t& utf16_location, std::size_t& utf16_length) const
+{
+    if(utf8_length == 0 || utf8_length > text_size || utf8_location > text_size - utf8_length)
+        return false;
+
+    std::size_t begin = 0;
+    if(!utf16_offset(utf8_location, begin))
+        return false;
+
+    /// Engine may report end in the middle of a multibyte sequence, round it up to the next code point
+    std::size_t end_offset = utf8_location + utf8_length;
+    while(end_offset < text_size && is_continuation_byte(static_cast<unsigned char>(text[end_offset])))
+        ++end_offset;
+    end_offset = extend_to_character_end(end_offset);
+
+    std::size_t end = 0;
+    if(!utf16_offset(end_offset, end))
+        return false;
+
+    utf16_location = begin;
+    utf16_length = end - begin;
+    return true;
+}
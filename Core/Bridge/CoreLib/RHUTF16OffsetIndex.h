@@ -0,0 +1,68 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+
+#ifndef RHUTF16OffsetIndex_h
+#define RHUTF16OffsetIndex_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RHVoice {
+
+/// Maps byte offsets in UTF-8 text, that engine reports markers with, to UTF-16 offsets used by NSString.
+/// Built in one pass over the text. Keeps a checkpoint every `checkpoint_interval` bytes,
+/// so a lookup is a binary search plus a scan of at most one interval.
+class utf16_offset_index
+{
+public:
+    /// UTF-8 `text` is not copied and has to outlive the index.
+    utf16_offset_index(const char* text, std::size_t text_size);
+
+    /// Returns false if range is empty, out of text or does not start at a code point.
+    /// End of the range is moved forward over combining marks, variation selectors,
+    /// emoji modifiers and zero width joiner sequences, so a range never splits a visible character.
+    bool utf16_range(std::size_t utf8_location, std::size_t utf8_length,
+                     std::size_t& utf16_location, std::size_t& utf16_length) const;
+    std::size_t utf16_size() const;
+
+private:
+    static const std::size_t checkpoint_interval = 64;
+
+    struct checkpoint
+    {
+        std::uint32_t utf8_offset;
+        std::uint32_t utf16_offset;
+    };
+
+    bool utf16_offset(std::size_t utf8_offset, std::size_t& result) const;
+    std::size_t extend_to_character_end(std::size_t utf8_offset) const;
+    std::size_t decode(std::size_t utf8_offset, std::uint32_t& code_point) const;
+
+    const char* const text;
+    const std::size_t text_size;
+    std::vector<checkpoint> checkpoints;
+    std::size_t total_utf16_size;
+};
+
+}
+#endif /* RHUTF16OffsetIndex_h */
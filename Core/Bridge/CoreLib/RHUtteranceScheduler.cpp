@@ -0,0 +1,295 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHUtteranceScheduler.h"
+
+#include <utility>
+
+#include "RHTrace.h"
+
+namespace RHVoice {
+
+const std::size_t utterance_scheduler::priority_count;
+
+utterance_scheduler::state::state():
+    next_identifier(1),
+    stopping(false)
+{
+    stats.completed = 0;
+    stats.cancelled_while_running = 0;
+    stats.cancelled_before_start = 0;
+}
+
+utterance_scheduler::utterance_scheduler():
+    shared(std::make_shared<state>())
+{
+    worker = std::thread(&utterance_scheduler::work, shared);
+}
+
+utterance_scheduler::~utterance_scheduler()
+{
+    cancel_function cancel;
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        shared->stopping = true;
+        cancel = cancel_running(*shared);
+        cancel_pending(*shared, priority_count);
+    }
+    shared->work_available.notify_all();
+    if(cancel)
+    {
+        cancel();
+    }
+
+    if(worker.get_id() == std::this_thread::get_id())
+    {
+        /// The last owner went away inside of a task. Worker only touches `shared`, so it finishes on its own.
+        worker.detach();
+    }
+    else
+    {
+        worker.join();
+    }
+}
+
+utterance_scheduler::task_id utterance_scheduler::submit(utterance_priority priority, task_function function, cancel_function cancel)
+{
+    std::shared_ptr<task> item = std::make_shared<task>();
+    item->priority = priority;
+    item->function = std::move(function);
+    item->cancel = std::move(cancel);
+    item->cancelled = false;
+    item->submitted = trace::is_enabled() ? trace::now() : 0;
+
+    cancel_function preempt;
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        item->identifier = shared->next_identifier++;
+        if(shared->stopping)
+        {
+            item->cancelled = true;
+        }
+        if(shared->running && shared->running->priority < priority)
+        {
+            preempt = cancel_running(*shared);
+        }
+        if(priority == utterance_priority_interrupt)
+        {
+            cancel_pending(*shared, priority);
+        }
+        shared->pending[priority].push_back(item);
+    }
+    shared->work_available.notify_one();
+    if(preempt)
+    {
+        preempt();
+    }
+    return item->identifier;
+}
+
+bool utterance_scheduler::cancel(task_id identifier)
+{
+    cancel_function cancel;
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        if(shared->running && shared->running->identifier == identifier)
+        {
+            cancel = cancel_running(*shared);
+        }
+        else
+        {
+            bool found = false;
+            for(std::size_t priority = 0; priority < priority_count && !found; ++priority)
+            {
+                for(const std::shared_ptr<task>& item: shared->pending[priority])
+                {
+                    if(item->identifier == identifier)
+                    {
+                        item->cancelled = true;
+                        found = true;
+                        break;
+                    }
+                }
+            }
+            if(!found)
+            {
+                return false;
+            }
+        }
+    }
+    if(cancel)
+    {
+        cancel();
+    }
+    return true;
+}
+
+void utterance_scheduler::cancel_all()
+{
+    cancel_function cancel;
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        cancel = cancel_running(*shared);
+        cancel_pending(*shared, priority_count);
+    }
+    if(cancel)
+    {
+        cancel();
+    }
+}
+
+void utterance_scheduler::wait_until_idle()
+{
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->idle.wait(lock, [this]() {
+        if(shared->running)
+        {
+            return false;
+        }
+        for(std::size_t priority = 0; priority < priority_count; ++priority)
+        {
+            if(!shared->pending[priority].empty())
+            {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+std::size_t utterance_scheduler::pending_count() const
+{
+    std::lock_guard<std::mutex> lock(shared->mutex);
+    std::size_t count = 0;
+    for(std::size_t priority = 0; priority < priority_count; ++priority)
+    {
+        count += shared->pending[priority].size();
+    }
+    return count;
+}
+
+utterance_scheduler::statistics utterance_scheduler::get_statistics() const
+{
+    std::lock_guard<std::mutex> lock(shared->mutex);
+    return shared->stats;
+}
+
+void utterance_scheduler::work(std::shared_ptr<state> shared)
+{
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    while(true)
+    {
+        std::shared_ptr<task> item = take_next(*shared);
+        if(!item)
+        {
+            if(shared->stopping)
+            {
+                return;
+            }
+            shared->idle.notify_all();
+            shared->work_available.wait(lock);
+            continue;
+        }
+
+        const bool cancelled_before_start = item->cancelled;
+        shared->running = item;
+        lock.unlock();
+
+        if(item->submitted != 0)
+            trace::record("scheduler.wait", item->submitted, trace::now());
+        try
+        {
+            RH_TRACE_SPAN("scheduler.task");
+            item->function(item->cancelled);
+        }
+        catch(...)
+        {
+            /// Tasks report their own errors, one failed utterance must not stop the queue
+        }
+
+        lock.lock();
+        shared->running.reset();
+        if(cancelled_before_start)
+        {
+            ++shared->stats.cancelled_before_start;
+        }
+        else if(item->cancelled)
+        {
+            ++shared->stats.cancelled_while_running;
+        }
+        else
+        {
+            ++shared->stats.completed;
+        }
+    }
+}
+
+std::shared_ptr<utterance_scheduler::task> utterance_scheduler::take_next(state& shared)
+{
+    for(std::size_t priority = 0; priority < priority_count; ++priority)
+    {
+        std::deque<std::shared_ptr<task>>& queue = shared.pending[priority];
+        for(std::deque<std::shared_ptr<task>>::iterator it = queue.begin(); it != queue.end(); ++it)
+        {
+            if((*it)->cancelled)
+            {
+                std::shared_ptr<task> item = *it;
+                queue.erase(it);
+                return item;
+            }
+        }
+    }
+
+    for(std::size_t priority = priority_count; priority-- > 0;)
+    {
+        std::deque<std::shared_ptr<task>>& queue = shared.pending[priority];
+        if(!queue.empty())
+        {
+            std::shared_ptr<task> item = queue.front();
+            queue.pop_front();
+            return item;
+        }
+    }
+    return std::shared_ptr<task>();
+}
+
+utterance_scheduler::cancel_function utterance_scheduler::cancel_running(state& shared)
+{
+    if(!shared.running || shared.running->cancelled)
+    {
+        return cancel_function();
+    }
+    shared.running->cancelled = true;
+    return shared.running->cancel;
+}
+
+void utterance_scheduler::cancel_pending(state& shared, std::size_t priority_limit)
+{
+    for(std::size_t priority = 0; priority < priority_limit && priority < priority_count; ++priority)
+    {
+        for(const std::shared_ptr<task>& item: shared.pending[priority])
+        {
+            item->cancelled = true;
+        }
+    }
+}
+
+}
@@ -0,0 +1,123 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHUtteranceScheduler_h
+#define RHUtteranceScheduler_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace RHVoice {
+
+enum utterance_priority
+{
+    utterance_priority_background,
+    utterance_priority_normal,
+    utterance_priority_interrupt
+};
+
+/// Runs utterance tasks one at a time on its own thread.
+/// Pending tasks are taken by priority, in submission order within a priority.
+/// A submitted task preempts the running one if its priority is higher: the running task is cancelled
+/// and is not resumed later. Interrupt tasks also cancel all pending tasks of lower priority.
+class utterance_scheduler
+{
+public:
+    typedef std::uint64_t task_id;
+    /// Called on the scheduler thread. Cancelled tasks are still called with `cancelled` set,
+    /// so they can report completion; they have to return as soon as possible then.
+    typedef std::function<void(const std::atomic<bool>& cancelled)> task_function;
+    /// Called at most once, on the thread that cancels the task, while task is running.
+    /// Has to make the running task return, e.g. by cancelling its client.
+    typedef std::function<void()> cancel_function;
+
+    struct statistics
+    {
+        std::uint64_t completed;
+        std::uint64_t cancelled_while_running;
+        std::uint64_t cancelled_before_start;
+    };
+
+    utterance_scheduler();
+    /// Cancels all tasks and waits for the running one, unless called from the task itself.
+    ~utterance_scheduler();
+
+    task_id submit(utterance_priority priority, task_function task, cancel_function cancel);
+    /// Returns false if task is already finished
+    bool cancel(task_id identifier);
+    void cancel_all();
+    /// Returns when there are neither pending nor running tasks
+    void wait_until_idle();
+    std::size_t pending_count() const;
+    statistics get_statistics() const;
+
+private:
+    static const std::size_t priority_count = utterance_priority_interrupt + 1;
+
+    struct task
+    {
+        task_id identifier;
+        utterance_priority priority;
+        task_function function;
+        cancel_function cancel;
+        std::atomic<bool> cancelled;
+        /// Zero when tracing was off
+        std::uint64_t submitted;
+    };
+
+    struct state
+    {
+        state();
+
+        mutable std::mutex mutex;
+        std::condition_variable work_available;
+        std::condition_variable idle;
+        std::deque<std::shared_ptr<task>> pending[priority_count];
+        std::shared_ptr<task> running;
+        task_id next_identifier;
+        bool stopping;
+        statistics stats;
+    };
+
+    static void work(std::shared_ptr<state> shared);
+    /// Cancelled tasks go first, so they report completion without waiting for others
+    static std::shared_ptr<task> take_next(state& shared);
+    /// Has to be called with mutex locked. Returns cancel function to call after unlocking.
+    static cancel_function cancel_running(state& shared);
+    /// Cancels pending tasks with priority lower than `priority_limit`
+    static void cancel_pending(state& shared, std::size_t priority_limit);
+
+    utterance_scheduler(const utterance_scheduler&);
+    utterance_scheduler& operator=(const utterance_scheduler&);
+
+    std::shared_ptr<state> shared;
+    std::thread worker;
+};
+
+}
+#endif /* RHUtteranceScheduler_h */
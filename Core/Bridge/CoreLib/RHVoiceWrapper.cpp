@@ -69,7 +69,7 @@ bool audio_player::set_buffer_size(unsigned int buffer_size)
     }
 }
 
-bool audio_player::play_speech(const short* samples,std::size_t count)
+bool audio_player::write(const short* samples,std::size_t count)
 {
     try
     {
@@ -85,9 +85,67 @@ bool audio_player::play_speech(const short* samples,std::size_t count)
     }
 }
 
-void audio_player::finish()
+bool audio_player::finish()
 {
-    if(stream.is_open())
-        stream.drain();
+    try
+    {
+        if(stream.is_open())
+            stream.drain();
+        return true;
+    }
+    catch(...)
+    {
+        return false;
+    }
+}
+
+
+stream_player::stream_player(pcm_ring_buffer& buffer):
+    buffer(buffer),
+    started(false)
+{
+}
+
+event_mask stream_player::get_supported_events() const
+{
+    return event_audio | event_done;
+}
+
+bool stream_player::play_speech(const short* samples,std::size_t count)
+{
+    if(!buffer.write(samples,count))
+        return false;
+
+    if(!started)
+    {
+        started = true;
+        if(first_chunk_callback)
+            first_chunk_callback();
+    }
+    return true;
+}
+
+unsigned int stream_player::get_audio_buffer_size() const
+{
+    return 20;
+}
+
+void stream_player::done()
+{
+    buffer.finish();
 }
 
+void stream_player::set_first_chunk_callback(const std::function<void()>& callback)
+{
+    first_chunk_callback = callback;
+}
+
+event_mask warm_up_player::get_supported_events() const
+{
+    return event_audio;
+}
+
+bool warm_up_player::play_speech(const short*,std::size_t)
+{
+    return false;
+}
@@ -29,20 +29,25 @@
 #include <fstream>
 #include <iterator>
 #include <algorithm>
+#include <functional>
 
 #include "core/engine.hpp"
 #include "core/document.hpp"
 #include "core/client.hpp"
 #include "audio.hpp"
 
+#include "RHBufferedFileClient.h"
+#include "RHPCMRingBuffer.h"
+
 namespace RHVoice {
 
-class audio_player: public RHVoice::client
+/// Writes uncompressed WAV file through engine audio library
+class audio_player: public audio_file_sink
 {
 public:
     explicit audio_player(const std::string& path);
-    bool play_speech(const short* samples,std::size_t count);
-    void finish();
+    bool write(const short* samples,std::size_t count) override;
+    bool finish() override;
     bool set_sample_rate(int sample_rate);
     bool set_buffer_size(unsigned int buffer_size);
     
@@ -50,5 +55,32 @@ private:
     RHVoice::audio::playback_stream stream;
 };
 
+/// Client that pushes synthesized samples into `pcm_ring_buffer` as soon as engine produces them,
+/// so playback can start after the first chunk instead of after the whole document.
+class stream_player: public RHVoice::client
+{
+public:
+    explicit stream_player(pcm_ring_buffer& buffer);
+    event_mask get_supported_events() const override;
+    bool play_speech(const short* samples,std::size_t count) override;
+    unsigned int get_audio_buffer_size() const override;
+    void done() override;
+    void set_first_chunk_callback(const std::function<void()>& callback);
+
+private:
+    pcm_ring_buffer& buffer;
+    std::function<void()> first_chunk_callback;
+    bool started;
+};
+
+/// Client that throws away audio and stops synthesis at the first chunk.
+/// Used to make engine load voice and language data before the first real request.
+class warm_up_player: public RHVoice::client
+{
+public:
+    event_mask get_supported_events() const override;
+    bool play_speech(const short* samples,std::size_t count) override;
+};
+
 }
 #endif /* RHVoiceWrapper_h */
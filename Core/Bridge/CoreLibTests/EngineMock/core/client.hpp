@@ -0,0 +1,91 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHVOICE_MOCK_CLIENT_HPP
+#define RHVOICE_MOCK_CLIENT_HPP
+
+#include <cstddef>
+
+/// Subset of the engine client interface used by CoreLib, so CoreLib can be tested without the engine
+namespace RHVoice
+{
+    typedef unsigned int event_mask;
+
+    const event_mask event_sentence_starts = 1;
+    const event_mask event_sentence_ends = 2;
+    const event_mask event_word_starts = 4;
+    const event_mask event_word_ends = 8;
+    const event_mask event_audio = 16;
+    const event_mask event_done = 64;
+
+    class client
+    {
+    public:
+        virtual ~client()
+        {
+        }
+
+        virtual event_mask get_supported_events() const
+        {
+            return 0;
+        }
+
+        virtual bool sentence_starts(std::size_t, std::size_t)
+        {
+            return true;
+        }
+
+        virtual bool sentence_ends(std::size_t, std::size_t)
+        {
+            return true;
+        }
+
+        virtual bool word_starts(std::size_t, std::size_t)
+        {
+            return true;
+        }
+
+        virtual bool word_ends(std::size_t, std::size_t)
+        {
+            return true;
+        }
+
+        virtual bool set_sample_rate(int)
+        {
+            return true;
+        }
+
+        virtual bool play_speech(const short*, std::size_t)
+        {
+            return true;
+        }
+
+        virtual void done()
+        {
+        }
+
+        virtual unsigned int get_audio_buffer_size() const
+        {
+            return 0;
+        }
+    };
+}
+#endif
@@ -0,0 +1,165 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHVOICE_MOCK_DOCUMENT_HPP
+#define RHVOICE_MOCK_DOCUMENT_HPP
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/engine.hpp"
+#include "core/client.hpp"
+
+namespace RHVoice
+{
+    enum content_type
+    {
+        content_text,
+        content_chars,
+        content_key
+    };
+
+    struct relative_speech_settings
+    {
+        relative_speech_settings():
+            rate(1),
+            pitch(1),
+            volume(1)
+        {
+        }
+
+        double rate;
+        double pitch;
+        double volume;
+    };
+
+    struct speech_settings_t
+    {
+        relative_speech_settings relative;
+    };
+
+    struct quality_setting
+    {
+        void set_from_string(const std::string& value)
+        {
+            name = value;
+        }
+
+        std::string name;
+    };
+
+    /// Synthesizes every space separated word into audio derived from its bytes and volume,
+    /// spending `engine::word_cost_microseconds` of CPU on it. Output only depends on text and volume,
+    /// so the same text gives the same audio and events however it is scheduled.
+    class document
+    {
+    public:
+        static const std::size_t samples_per_byte = 40;
+
+        template<typename input_iterator>
+        static std::unique_ptr<document> create_from_plain_text(const std::shared_ptr<engine>& engine_ptr, input_iterator begin, input_iterator end, content_type, const voice_profile& = voice_profile())
+        {
+            return std::unique_ptr<document>(new document(engine_ptr, std::string(begin, end)));
+        }
+
+        template<typename input_iterator>
+        static std::unique_ptr<document> create_from_ssml(const std::shared_ptr<engine>& engine_ptr, input_iterator begin, input_iterator end, const voice_profile& = voice_profile())
+        {
+            return std::unique_ptr<document>(new document(engine_ptr, std::string(begin, end)));
+        }
+
+        void set_owner(client& value)
+        {
+            owner = &value;
+        }
+
+        void synthesize()
+        {
+            const event_mask events = owner->get_supported_events();
+            bool sentence_start = true;
+            std::size_t position = 0;
+            while(true)
+            {
+                while(position < text.size() && text[position] == ' ')
+                    ++position;
+                if(position == text.size())
+                    break;
+
+                std::size_t end = position;
+                while(end < text.size() && text[end] != ' ')
+                    ++end;
+
+                if(sentence_start && (events & event_sentence_starts) && !owner->sentence_starts(position, end - position))
+                    return;
+                if((events & event_word_starts) && !owner->word_starts(position, end - position))
+                    return;
+                if((events & event_audio) && !owner->play_speech(samples.data(), render_word(position, end)))
+                    return;
+                if((events & event_word_ends) && !owner->word_ends(position, end - position))
+                    return;
+
+                const char last = text[end - 1];
+                sentence_start = last == '.' || last == '!' || last == '?';
+                position = end;
+            }
+            owner->done();
+        }
+
+        speech_settings_t speech_settings;
+        quality_setting quality;
+
+    private:
+        document(const std::shared_ptr<engine>& engine_ptr, const std::string& text):
+            engine_ptr(engine_ptr),
+            text(text),
+            owner(nullptr)
+        {
+        }
+
+        std::size_t render_word(std::size_t begin, std::size_t end)
+        {
+            const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(engine_ptr->word_cost_microseconds.load());
+            while(std::chrono::steady_clock::now() < deadline)
+            {
+            }
+
+            samples.clear();
+            for(std::size_t index = begin; index < end; ++index)
+            {
+                double value = static_cast<unsigned char>(text[index]) * 128 * speech_settings.relative.volume;
+                value = value > 32767 ? 32767 : value;
+                samples.insert(samples.end(), samples_per_byte, static_cast<short>(value));
+            }
+            return samples.size();
+        }
+
+        document(const document&);
+        document& operator=(const document&);
+
+        std::shared_ptr<engine> engine_ptr;
+        std::string text;
+        client* owner;
+        std::vector<short> samples;
+    };
+}
+#endif
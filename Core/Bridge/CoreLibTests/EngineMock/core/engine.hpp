@@ -0,0 +1,56 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHVOICE_MOCK_ENGINE_HPP
+#define RHVOICE_MOCK_ENGINE_HPP
+
+#include <atomic>
+#include <string>
+
+namespace RHVoice
+{
+    class voice_profile
+    {
+    };
+
+    /// Stateless like a loaded engine: documents only read from it, so it can be shared between threads
+    class engine
+    {
+    public:
+        engine():
+            word_cost_microseconds(200)
+        {
+        }
+
+        voice_profile create_voice_profile(const std::string&) const
+        {
+            return voice_profile();
+        }
+
+        /// CPU time a document spends on every word, to model synthesis load
+        std::atomic<unsigned int> word_cost_microseconds;
+
+    private:
+        engine(const engine&);
+        engine& operator=(const engine&);
+    };
+}
+#endif
@@ -0,0 +1,124 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <mutex>
+#include <thread>
+
+#include "RHAsyncLogger.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+class collected_records
+{
+public:
+    async_logger::sink_function sink()
+    {
+        return [this](int, const char*, std::size_t, const char* message, std::size_t message_size) {
+            std::lock_guard<std::mutex> lock(mutex);
+            messages.push_back(std::string(message, message_size));
+        };
+    }
+
+    std::size_t count()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return messages.size();
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<std::string> messages;
+};
+
+bool log_message(async_logger& logger, int level, const std::string& message)
+{
+    return logger.log(level, "tag", 3, message.data(), message.size());
+}
+
+}
+
+/// Bursts with pauses in between, so logger thread goes to sleep and has to be woken up
+RH_TEST(async_logger_delivers_records_of_all_threads)
+{
+    collected_records records;
+    async_logger logger(1024, 2, records.sink());
+    std::vector<std::thread> threads;
+    for(int index = 0; index < 4; ++index)
+    {
+        threads.push_back(std::thread([&logger]() {
+            for(int record = 0; record < 500; ++record)
+            {
+                log_message(logger, record % 4, "message " + std::to_string(record));
+                if(record % 100 == 0)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }));
+    }
+    for(std::thread& thread: threads)
+        thread.join();
+    logger.flush();
+
+    const async_logger::statistics statistics = logger.get_statistics();
+    RH_CHECK(statistics.delivered + statistics.dropped == 4 * 250);
+    RH_CHECK(records.count() == statistics.delivered);
+}
+
+/// Logger thread waits without a timeout, a record logged while it sleeps must wake it up
+RH_TEST(async_logger_wakes_up_for_record_after_idle)
+{
+    collected_records records;
+    async_logger logger(16, 0, records.sink());
+    for(int round = 0; round < 20; ++round)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        RH_CHECK(log_message(logger, 1, "after idle"));
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while(records.count() < static_cast<std::size_t>(round + 1) && elapsed_milliseconds(start) < 1000)
+            std::this_thread::yield();
+        RH_CHECK(records.count() == static_cast<std::size_t>(round + 1));
+    }
+}
+
+RH_TEST(async_logger_applies_min_level_change)
+{
+    collected_records records;
+    async_logger logger(16, 3, records.sink());
+    RH_CHECK(!log_message(logger, 1, "filtered"));
+    logger.set_min_level(1);
+    RH_CHECK(log_message(logger, 1, "accepted"));
+    logger.flush();
+    RH_CHECK(records.count() == 1);
+}
+
+RH_TEST(async_logger_delivers_everything_before_destruction)
+{
+    collected_records records;
+    {
+        async_logger logger(64, 0, records.sink());
+        for(int record = 0; record < 10; ++record)
+            log_message(logger, 1, "record");
+    }
+    RH_CHECK(records.count() == 10);
+}
@@ -0,0 +1,116 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <thread>
+
+#include "RHBufferedFileClient.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+/// Slow enough that the writer falls behind small buffers
+class vector_sink: public audio_file_sink
+{
+public:
+    vector_sink():
+        finished(false),
+        write_count(0),
+        failing_write(0)
+    {
+    }
+
+    bool write(const short* samples, std::size_t count) override
+    {
+        if(++write_count == failing_write)
+            return false;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        written.insert(written.end(), samples, samples + count);
+        return true;
+    }
+
+    bool finish() override
+    {
+        finished = true;
+        return true;
+    }
+
+    std::vector<short> written;
+    bool finished;
+    std::size_t write_count;
+    /// 1-based number of the write that fails, 0 for none
+    std::size_t failing_write;
+};
+
+}
+
+/// Run it under make tsan, the writer thread reads buffers the synthesis thread fills
+RH_TEST(buffered_file_client_writes_every_sample_in_order)
+{
+    const std::size_t buffer_sizes[] = {1, 7, 100, 4096};
+    for(std::size_t buffer_size: buffer_sizes)
+    {
+        vector_sink sink;
+        std::vector<short> expected;
+        {
+            buffered_file_client buffered(sink, buffer_size);
+            for(int chunk = 0; chunk < 500; ++chunk)
+            {
+                short samples[37];
+                for(int index = 0; index < 37; ++index)
+                    samples[index] = static_cast<short>(chunk * 37 + index);
+                expected.insert(expected.end(), samples, samples + 37);
+                RH_CHECK(buffered.play_speech(samples, 37));
+            }
+            RH_CHECK(buffered.finish());
+            RH_CHECK(buffered.get_statistics().samples == expected.size());
+        }
+        RH_CHECK(sink.finished);
+        RH_CHECK(sink.written == expected);
+    }
+}
+
+RH_TEST(buffered_file_client_stops_synthesis_when_sink_fails)
+{
+    vector_sink sink;
+    sink.failing_write = 2;
+    buffered_file_client buffered(sink, 10);
+    const short samples[10] = {0};
+    bool accepted = true;
+    for(int chunk = 0; chunk < 50 && accepted; ++chunk)
+        accepted = buffered.play_speech(samples, 10);
+    RH_CHECK(!accepted);
+    RH_CHECK(!buffered.finish());
+}
+
+RH_TEST(buffered_file_client_finishes_sink_when_destroyed_without_finish)
+{
+    vector_sink sink;
+    {
+        buffered_file_client buffered(sink, 10);
+        const short samples[5] = {1, 2, 3, 4, 5};
+        buffered.play_speech(samples, 5);
+    }
+    RH_CHECK(sink.finished);
+    RH_CHECK(sink.written.size() == 5);
+}
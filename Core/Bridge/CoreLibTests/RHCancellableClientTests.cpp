@@ -0,0 +1,136 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <thread>
+
+#include "RHCancellableClient.h"
+#include "RHParallelDocument.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+/// Client that only wants audio, like a file writer
+class audio_sink: public client
+{
+public:
+    audio_sink():
+        samples(0),
+        done_called(false)
+    {
+    }
+
+    event_mask get_supported_events() const override
+    {
+        return event_audio | event_done;
+    }
+
+    bool play_speech(const short*, std::size_t count) override
+    {
+        samples += count;
+        return true;
+    }
+
+    void done() override
+    {
+        done_called = true;
+    }
+
+    std::size_t samples;
+    bool done_called;
+};
+
+}
+
+RH_TEST(cancellable_client_forwards_everything_when_not_cancelled)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    engine_ptr->word_cost_microseconds = 0;
+    const std::string text = numbered_sentences(5);
+    recording_sink reference;
+    {
+        std::unique_ptr<document> doc = document::create_from_plain_text(engine_ptr, text.begin(), text.end(), content_text);
+        doc->set_owner(reference);
+        doc->synthesize();
+    }
+
+    std::atomic<bool> cancelled(false);
+    recording_sink sink;
+    cancellable_client cancellable(sink, cancelled);
+    std::unique_ptr<document> doc = document::create_from_plain_text(engine_ptr, text.begin(), text.end(), content_text);
+    doc->set_owner(cancellable);
+    doc->synthesize();
+
+    RH_CHECK(sink.samples == reference.samples);
+    RH_CHECK(sink.word_positions == reference.word_positions);
+    RH_CHECK(sink.done_count == 1);
+}
+
+RH_TEST(cancellable_client_stops_between_words_of_audio_only_owner)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const std::string text = numbered_sentences(2000);
+    std::atomic<bool> cancelled(false);
+    audio_sink sink;
+    cancellable_client cancellable(sink, cancelled);
+    std::unique_ptr<document> doc = document::create_from_plain_text(engine_ptr, text.begin(), text.end(), content_text);
+    doc->set_owner(cancellable);
+
+    std::thread canceller([&cancelled]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        cancelled = true;
+    });
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    doc->synthesize();
+    const double duration = elapsed_milliseconds(start);
+    canceller.join();
+
+    RH_CHECK(!sink.done_called);
+    RH_CHECK(sink.samples > 0);
+    /// Whole text takes more than a second of mock engine time
+    RH_CHECK(duration < 500);
+}
+
+RH_TEST(cancelled_parallel_document_does_not_report_done)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const std::string text = numbered_sentences(2000);
+    std::atomic<bool> cancelled(false);
+    audio_sink sink;
+    cancellable_client cancellable(sink, cancelled);
+    parallel_document_settings settings;
+    settings.thread_count = 4;
+    settings.min_piece_size = 50;
+    settings.cancellation = &cancelled;
+    parallel_document doc(engine_ptr, text.data(), text.size(), settings);
+    doc.set_owner(cancellable);
+
+    std::thread canceller([&cancelled]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        cancelled = true;
+    });
+    doc.synthesize();
+    canceller.join();
+
+    RH_CHECK(!sink.done_called);
+}
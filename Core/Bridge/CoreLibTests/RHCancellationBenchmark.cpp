@@ -0,0 +1,87 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <thread>
+
+#include "RHCancellableClient.h"
+#include "RHParallelDocument.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+typedef std::chrono::steady_clock test_clock;
+
+namespace {
+
+/// Cancels a long synthesis 5-11 ms after it started and returns time from cancel to `synthesize` returning
+template<typename Synthesize>
+std::vector<double> measure_cancel_latency(Synthesize synthesize)
+{
+    std::vector<double> latencies;
+    for(int run = 0; run < 30; ++run)
+    {
+        std::atomic<bool> cancelled(false);
+        recording_sink sink;
+        cancellable_client cancellable(sink, cancelled);
+        test_clock::time_point cancelled_at;
+        std::thread canceller([&cancelled, &cancelled_at, run]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5 + run % 7));
+            cancelled_at = test_clock::now();
+            cancelled = true;
+        });
+        synthesize(cancellable, cancelled);
+        const test_clock::time_point returned_at = test_clock::now();
+        canceller.join();
+        RH_CHECK(sink.done_count == 0);
+        latencies.push_back(std::chrono::duration<double, std::micro>(returned_at - cancelled_at).count());
+    }
+    return latencies;
+}
+
+}
+
+/// Mock engine makes a callback every 200 us, the bound on cancel latency is the gap between two callbacks
+RH_TEST(cancel_to_return_latency_on_long_input)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const std::string text = numbered_sentences(2000);
+
+    const std::vector<double> serial = measure_cancel_latency([&engine_ptr, &text](client& owner, const std::atomic<bool>&) {
+        std::unique_ptr<document> doc = document::create_from_plain_text(engine_ptr, text.begin(), text.end(), content_text);
+        doc->set_owner(owner);
+        doc->synthesize();
+    });
+    report_value("cancellation.serial.p50", percentile(serial, 0.5), "us");
+    report_value("cancellation.serial.p99", percentile(serial, 0.99), "us");
+
+    const std::vector<double> parallel = measure_cancel_latency([&engine_ptr, &text](client& owner, const std::atomic<bool>& cancelled) {
+        parallel_document_settings settings;
+        settings.thread_count = 4;
+        settings.min_piece_size = 50;
+        settings.cancellation = &cancelled;
+        parallel_document doc(engine_ptr, text.data(), text.size(), settings);
+        doc.set_owner(owner);
+        doc.synthesize();
+    });
+    report_value("cancellation.parallel.p50", percentile(parallel, 0.5), "us");
+    report_value("cancellation.parallel.p99", percentile(parallel, 0.99), "us");
+}
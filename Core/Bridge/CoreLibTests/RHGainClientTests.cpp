@@ -0,0 +1,76 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+#include "RHGainClient.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+const short input[] = {0, 100, -100, 3, -3, 20000, -20000, 32767, -32768};
+const std::size_t input_count = sizeof(input) / sizeof(input[0]);
+
+std::vector<short> scaled(double gain)
+{
+    recording_sink sink;
+    gain_client gain_client(sink, gain);
+    RH_CHECK(gain_client.play_speech(input, input_count));
+    return sink.samples;
+}
+
+}
+
+RH_TEST(gain_rounds_scaled_samples_to_nearest)
+{
+    const short expected[] = {0, 50, -50, 2, -1, 10000, -10000, 16384, -16384};
+    RH_CHECK(scaled(0.5) == std::vector<short>(expected, expected + input_count));
+    RH_CHECK(scaled(1.0) == std::vector<short>(input, input + input_count));
+}
+
+RH_TEST(gain_saturates_to_16_bit)
+{
+    const short expected[] = {0, 200, -200, 6, -6, 32767, -32768, 32767, -32768};
+    RH_CHECK(scaled(2.0) == std::vector<short>(expected, expected + input_count));
+}
+
+RH_TEST(gain_forwards_markers_and_done)
+{
+    recording_sink sink;
+    gain_client gain_client(sink, 0.5);
+    RH_CHECK(gain_client.get_supported_events() == sink.get_supported_events());
+    RH_CHECK(gain_client.sentence_starts(0, 5));
+    RH_CHECK(gain_client.word_starts(6, 3));
+    gain_client.done();
+    RH_CHECK(sink.sentence_positions == std::vector<std::size_t>(1, 0));
+    RH_CHECK(sink.word_positions == std::vector<std::size_t>(1, 6));
+    RH_CHECK(sink.done_count == 1);
+}
+
+RH_TEST(gain_passes_stop_request_of_owner)
+{
+    recording_sink sink;
+    sink.sample_limit = 1;
+    gain_client gain_client(sink, 2.0);
+    RH_CHECK(!gain_client.play_speech(input, input_count));
+}
@@ -0,0 +1,89 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <thread>
+
+#include "RHIncrementalDocument.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+/// Remembers when the first audio arrived
+class first_audio_sink: public recording_sink
+{
+public:
+    first_audio_sink():
+        samples_received(0)
+    {
+    }
+
+    bool play_speech(const short* samples, std::size_t count) override
+    {
+        if(samples_received == 0)
+            first_audio = std::chrono::steady_clock::now();
+        samples_received += count;
+        return recording_sink::play_speech(samples, count);
+    }
+
+    std::chrono::steady_clock::time_point first_audio;
+    std::size_t samples_received;
+};
+
+}
+
+/// Text arrives 4 bytes every 2 ms, like a slow network stream
+RH_TEST(first_audio_latency_of_streamed_text)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const std::string data = numbered_sentences(10);
+    std::vector<double> first_audio;
+    std::vector<double> feed_time;
+    for(int run = 0; run < 10; ++run)
+    {
+        const std::shared_ptr<incremental_text> text = std::make_shared<incremental_text>();
+        incremental_document doc(engine_ptr, text, incremental_document_settings());
+        first_audio_sink sink;
+        doc.set_owner(sink);
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        double fed = 0;
+        std::thread writer([&text, &data, &fed, start]() {
+            for(std::size_t position = 0; position < data.size(); position += 4)
+            {
+                text->append(data.data() + position, std::min<std::size_t>(4, data.size() - position));
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            text->finish();
+            fed = elapsed_milliseconds(start);
+        });
+        doc.synthesize();
+        writer.join();
+        RH_CHECK(sink.done_count == 1);
+        first_audio.push_back(std::chrono::duration<double, std::milli>(sink.first_audio - start).count());
+        feed_time.push_back(fed);
+    }
+    report_value("incremental.first_sentence_bytes", data.find('.') + 1, "bytes");
+    report_value("incremental.first_audio.p50", percentile(first_audio, 0.5), "ms");
+    report_value("incremental.first_audio.max", percentile(first_audio, 1), "ms");
+    report_value("incremental.whole_feed.p50", percentile(feed_time, 0.5), "ms");
+}
@@ -0,0 +1,120 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <thread>
+
+#include "RHIncrementalDocument.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+const std::string streamed_text = "Hello there. This is a test, e.g. this one. Number 3.5 is fine! Last bit without end";
+
+void feed(incremental_text& text, const std::string& data, std::size_t chunk_size, std::chrono::milliseconds interval)
+{
+    for(std::size_t position = 0; position < data.size(); position += chunk_size)
+    {
+        text.append(data.data() + position, std::min(chunk_size, data.size() - position));
+        std::this_thread::sleep_for(interval);
+    }
+    text.finish();
+}
+
+}
+
+RH_TEST(streamed_text_sounds_like_whole_text)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const std::shared_ptr<incremental_text> text = std::make_shared<incremental_text>();
+    incremental_document doc(engine_ptr, text, incremental_document_settings());
+    recording_sink streamed;
+    doc.set_owner(streamed);
+    std::thread writer([&text]() {
+        feed(*text, streamed_text, 4, std::chrono::milliseconds(1));
+    });
+    doc.synthesize();
+    writer.join();
+
+    recording_sink whole;
+    std::unique_ptr<document> reference = document::create_from_plain_text(engine_ptr, streamed_text.begin(), streamed_text.end(), content_text);
+    reference->set_owner(whole);
+    reference->synthesize();
+
+    RH_CHECK(streamed.samples == whole.samples);
+    RH_CHECK(streamed.word_positions == whole.word_positions);
+    RH_CHECK(streamed.done_count == 1);
+    /// "e.g." and "3.5" don't end a piece
+    RH_CHECK(doc.piece_count() == 4);
+}
+
+RH_TEST(cancellation_stops_waiting_for_text)
+{
+    const std::shared_ptr<incremental_text> text = std::make_shared<incremental_text>();
+    std::atomic<bool> cancelled(false);
+    incremental_document_settings settings;
+    settings.cancellation = &cancelled;
+    incremental_document doc(std::make_shared<engine>(), text, settings);
+    recording_sink sink;
+    doc.set_owner(sink);
+    text->append("Waiting forever", 15);
+
+    std::thread canceller([&cancelled]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        cancelled = true;
+    });
+    doc.synthesize();
+    canceller.join();
+
+    RH_CHECK(doc.piece_count() == 0);
+    RH_CHECK(sink.done_count == 0);
+}
+
+RH_TEST(owner_stop_ends_synthesis_without_done)
+{
+    const std::shared_ptr<incremental_text> text = std::make_shared<incremental_text>();
+    incremental_document doc(std::make_shared<engine>(), text, incremental_document_settings());
+    recording_sink sink;
+    sink.sample_limit = 1;
+    doc.set_owner(sink);
+    text->append(streamed_text.data(), streamed_text.size());
+    text->finish();
+    doc.synthesize();
+
+    RH_CHECK(doc.piece_count() == 1);
+    RH_CHECK(sink.word_positions.size() == 1);
+    RH_CHECK(sink.done_count == 0);
+}
+
+RH_TEST(empty_finished_text_reports_done)
+{
+    const std::shared_ptr<incremental_text> text = std::make_shared<incremental_text>();
+    text->finish();
+    incremental_document doc(std::make_shared<engine>(), text, incremental_document_settings());
+    recording_sink sink;
+    doc.set_owner(sink);
+    doc.synthesize();
+
+    RH_CHECK(doc.piece_count() == 0);
+    RH_CHECK(sink.done_count == 1);
+}
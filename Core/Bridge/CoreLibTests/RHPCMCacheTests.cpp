@@ -0,0 +1,226 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include "RHPCMCache.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+/// Temporary directory for the disk tier, removed with everything in it
+class temporary_directory
+{
+public:
+    temporary_directory()
+    {
+        char name[] = "/tmp/rhvoice-cache-XXXXXX";
+        if(mkdtemp(name) != nullptr)
+            path = name;
+    }
+
+    ~temporary_directory()
+    {
+        DIR* directory = opendir(path.c_str());
+        if(directory == nullptr)
+            return;
+        while(dirent* item = readdir(directory))
+        {
+            const std::string name = item->d_name;
+            if(name != "." && name != "..")
+                std::remove((path + "/" + name).c_str());
+        }
+        closedir(directory);
+        rmdir(path.c_str());
+    }
+
+    std::size_t file_count() const
+    {
+        std::size_t count = 0;
+        DIR* directory = opendir(path.c_str());
+        if(directory == nullptr)
+            return count;
+        while(dirent* item = readdir(directory))
+        {
+            if(std::string(item->d_name).find(".rhuc") != std::string::npos)
+                ++count;
+        }
+        closedir(directory);
+        return count;
+    }
+
+    std::string path;
+
+private:
+    temporary_directory(const temporary_directory&);
+    temporary_directory& operator=(const temporary_directory&);
+};
+
+std::string cache_text(std::size_t number)
+{
+    return numbered_sentences(5) + "Text " + std::to_string(number) + ".";
+}
+
+/// Synthesizes `text` through a caching client that is gone once this returns
+void synthesize_into(const std::shared_ptr<engine>& engine_ptr, utterance_cache& cache, const std::string& text, client& owner)
+{
+    caching_client caching(owner, cache, text);
+    std::unique_ptr<document> doc = document::create_from_plain_text(engine_ptr, text.begin(), text.end(), content_text);
+    doc->set_owner(caching);
+    doc->synthesize();
+}
+
+std::size_t recording_size(const std::shared_ptr<engine>& engine_ptr)
+{
+    utterance_cache cache(1 << 20, std::string(), 0);
+    recording_sink sink;
+    synthesize_into(engine_ptr, cache, cache_text(0), sink);
+    return cache.get_statistics().memory_bytes;
+}
+
+bool replays_as(const std::shared_ptr<const recording_client>& recording, const recording_sink& reference)
+{
+    if(!recording)
+        return false;
+    recording_sink replayed;
+    return recording->replay(replayed, 0) && replayed.samples == reference.samples && replayed.word_positions == reference.word_positions && replayed.sentence_positions == reference.sentence_positions;
+}
+
+}
+
+RH_TEST(cache_recording_replays_after_caching_client_is_gone)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    utterance_cache cache(1 << 20, std::string(), 0);
+    recording_sink reference;
+    synthesize_into(engine_ptr, cache, cache_text(0), reference);
+
+    RH_CHECK(reference.done_count == 1);
+    RH_CHECK(replays_as(cache.find(cache_text(0)), reference));
+}
+
+RH_TEST(cache_does_not_keep_stopped_synthesis)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    utterance_cache cache(1 << 20, std::string(), 0);
+    recording_sink sink;
+    sink.sample_limit = 1;
+    synthesize_into(engine_ptr, cache, cache_text(0), sink);
+
+    RH_CHECK(!cache.find(cache_text(0)));
+}
+
+RH_TEST(cache_evicts_least_recently_used_from_memory)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    utterance_cache cache(recording_size(engine_ptr) * 2, std::string(), 0);
+    std::vector<recording_sink> references(3);
+    synthesize_into(engine_ptr, cache, cache_text(0), references[0]);
+    synthesize_into(engine_ptr, cache, cache_text(1), references[1]);
+    RH_CHECK(cache.find(cache_text(0)));
+    synthesize_into(engine_ptr, cache, cache_text(2), references[2]);
+
+    RH_CHECK(replays_as(cache.find(cache_text(0)), references[0]));
+    RH_CHECK(!cache.find(cache_text(1)));
+    RH_CHECK(replays_as(cache.find(cache_text(2)), references[2]));
+    const utterance_cache::statistics statistics = cache.get_statistics();
+    RH_CHECK(statistics.entry_count == 2);
+    RH_CHECK(statistics.misses == 1);
+}
+
+RH_TEST(cache_moves_evicted_entries_to_disk_and_back)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const temporary_directory directory;
+    utterance_cache cache(recording_size(engine_ptr), directory.path, 1 << 20);
+    std::vector<recording_sink> references(2);
+    synthesize_into(engine_ptr, cache, cache_text(0), references[0]);
+    synthesize_into(engine_ptr, cache, cache_text(1), references[1]);
+    RH_CHECK(directory.file_count() == 1);
+    RH_CHECK(cache.get_statistics().disk_bytes > 0);
+
+    RH_CHECK(replays_as(cache.find(cache_text(0)), references[0]));
+    RH_CHECK(replays_as(cache.find(cache_text(1)), references[1]));
+    const utterance_cache::statistics statistics = cache.get_statistics();
+    RH_CHECK(statistics.disk_hits == 2);
+    RH_CHECK(statistics.entry_count == 2);
+    RH_CHECK(directory.file_count() == 1);
+
+    cache.clear();
+    RH_CHECK(directory.file_count() == 0);
+    RH_CHECK(!cache.find(cache_text(0)));
+}
+
+/// Entries keep moving between memory and disk while other threads look them up. Run it under make tsan.
+RH_TEST(cache_disk_tier_is_safe_to_share_between_threads)
+{
+    const std::size_t text_count = 6;
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    std::vector<recording_sink> references(text_count);
+    {
+        utterance_cache scratch(1 << 20, std::string(), 0);
+        for(std::size_t number = 0; number < text_count; ++number)
+            synthesize_into(engine_ptr, scratch, cache_text(number), references[number]);
+    }
+
+    const temporary_directory directory;
+    utterance_cache cache(recording_size(engine_ptr) * 2, directory.path, 1 << 20);
+    std::atomic<std::size_t> mismatches(0);
+    std::vector<std::thread> threads;
+    for(std::size_t thread_number = 0; thread_number < 4; ++thread_number)
+    {
+        threads.push_back(std::thread([&, thread_number]() {
+            for(std::size_t round = 0; round < 200; ++round)
+            {
+                const std::size_t number = (round * 7 + thread_number) % text_count;
+                const std::shared_ptr<const recording_client> recording = cache.find(cache_text(number));
+                if(recording)
+                {
+                    if(!replays_as(recording, references[number]))
+                        ++mismatches;
+                    continue;
+                }
+                recording_sink sink;
+                synthesize_into(engine_ptr, cache, cache_text(number), sink);
+                if(sink.samples != references[number].samples)
+                    ++mismatches;
+            }
+        }));
+    }
+    for(std::thread& thread: threads)
+        thread.join();
+
+    RH_CHECK(mismatches == 0);
+    const utterance_cache::statistics statistics = cache.get_statistics();
+    RH_CHECK(statistics.disk_hits > 0);
+    RH_CHECK(statistics.entry_count <= text_count);
+    cache.clear();
+    RH_CHECK(directory.file_count() == 0);
+}
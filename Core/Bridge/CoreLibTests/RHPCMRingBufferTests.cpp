@@ -0,0 +1,177 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <atomic>
+#include <thread>
+
+#include "RHPCMRingBuffer.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+typedef std::chrono::steady_clock test_clock;
+
+RH_TEST(ring_buffer_keeps_sample_order)
+{
+    pcm_ring_buffer buffer(1000);
+    const std::size_t total = 1000000;
+    std::thread producer([&buffer, total]() {
+        std::vector<short> chunk(777);
+        std::size_t written = 0;
+        while(written < total)
+        {
+            const std::size_t count = std::min(chunk.size(), total - written);
+            for(std::size_t index = 0; index < count; ++index)
+                chunk[index] = static_cast<short>((written + index) & 0x7fff);
+            buffer.write(chunk.data(), count);
+            written += count;
+        }
+        buffer.finish();
+    });
+
+    std::size_t received = 0;
+    bool ordered = true;
+    short chunk[300];
+    while(!buffer.is_drained())
+    {
+        buffer.wait_for_frames(64, test_clock::now() + std::chrono::milliseconds(10));
+        const std::size_t count = buffer.read(chunk, 300);
+        for(std::size_t index = 0; index < count; ++index)
+            ordered = ordered && chunk[index] == static_cast<short>((received + index) & 0x7fff);
+        received += count;
+    }
+    producer.join();
+
+    RH_CHECK(ordered);
+    RH_CHECK(received == total);
+}
+
+RH_TEST(wait_for_frames_returns_at_deadline)
+{
+    pcm_ring_buffer buffer(16);
+    const test_clock::time_point start = test_clock::now();
+    const std::size_t available = buffer.wait_for_frames(1, start + std::chrono::milliseconds(50));
+    const double waited = elapsed_milliseconds(start);
+
+    RH_CHECK(available == 0);
+    RH_CHECK(waited >= 50);
+    RH_CHECK(waited < 1000);
+}
+
+RH_TEST(wait_for_frames_returns_when_finished)
+{
+    pcm_ring_buffer buffer(16);
+    const short samples[3] = {1, 2, 3};
+    buffer.try_write(samples, 3);
+    std::thread producer([&buffer]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        buffer.finish();
+    });
+
+    const std::size_t available = buffer.wait_for_frames(10, test_clock::now() + std::chrono::seconds(10));
+    producer.join();
+
+    RH_CHECK(available == 3);
+    RH_CHECK(buffer.is_finished());
+}
+
+/// Consumer never waits for the mutex, producer still notices every read while it sleeps
+RH_TEST(producer_resumes_after_render_reads)
+{
+    pcm_ring_buffer buffer(256);
+    const std::vector<short> samples(4096, 1);
+    std::thread producer([&buffer, &samples]() {
+        buffer.write(samples.data(), samples.size());
+        buffer.finish();
+    });
+
+    std::size_t received = 0;
+    short chunk[64];
+    while(received < samples.size())
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        received += buffer.read(chunk, 64);
+    }
+    RH_CHECK(buffer.wait_for_drain(std::chrono::seconds(10)));
+    producer.join();
+    RH_CHECK(received == samples.size());
+}
+
+RH_TEST(wait_for_drain_returns_soon_after_last_read)
+{
+    pcm_ring_buffer buffer(256);
+    const short samples[100] = {0};
+    buffer.try_write(samples, 100);
+    buffer.finish();
+    std::thread consumer([&buffer]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        short chunk[100];
+        buffer.read(chunk, 100);
+    });
+
+    const test_clock::time_point start = test_clock::now();
+    RH_CHECK(buffer.wait_for_drain(std::chrono::seconds(10)));
+    const double waited = elapsed_milliseconds(start);
+    consumer.join();
+    RH_CHECK(waited < 1000);
+}
+
+/// Producer writes a chunk every 20 ms, like an engine slower than real time.
+/// Consumer has to wake up as soon as the chunk is there, not at its deadline.
+RH_TEST(slow_producer_wakeup_latency)
+{
+    const std::size_t chunk_size = 480;
+    const int chunk_count = 20;
+    pcm_ring_buffer buffer(48000);
+    std::atomic<test_clock::rep> written_at(0);
+    std::thread producer([&buffer, &written_at, chunk_size, chunk_count]() {
+        const std::vector<short> chunk(chunk_size, 1);
+        for(int index = 0; index < chunk_count; ++index)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            written_at.store(test_clock::now().time_since_epoch().count());
+            buffer.write(chunk.data(), chunk.size());
+        }
+        buffer.finish();
+    });
+
+    std::vector<double> latencies;
+    std::vector<short> chunk(chunk_size);
+    while(true)
+    {
+        const std::size_t available = buffer.wait_for_frames(chunk_size, test_clock::now() + std::chrono::seconds(1));
+        const test_clock::rep woken_at = test_clock::now().time_since_epoch().count();
+        if(available == 0 && buffer.is_finished())
+            break;
+
+        const test_clock::duration latency(woken_at - written_at.load());
+        latencies.push_back(std::chrono::duration<double, std::micro>(latency).count());
+        buffer.read(chunk.data(), chunk.size());
+    }
+    producer.join();
+
+    RH_CHECK(latencies.size() == static_cast<std::size_t>(chunk_count));
+    report_value("ring_buffer.wakeup_latency.p50", percentile(latencies, 0.5), "us");
+    report_value("ring_buffer.wakeup_latency.max", percentile(latencies, 1), "us");
+    /// Far below the 20 ms producer period, otherwise consumer slept until its deadline
+    RH_CHECK(percentile(latencies, 0.5) < 10000);
+}
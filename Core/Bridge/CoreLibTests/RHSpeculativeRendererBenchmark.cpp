@@ -0,0 +1,94 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <thread>
+
+#include "RHSpeculativeRenderer.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+const int paragraph_count = 8;
+
+std::string paragraph(int number)
+{
+    std::string text;
+    for(int word = 0; word < 60; ++word)
+        text += "p" + std::to_string(number) + "w" + std::to_string(word) + " ";
+    return text;
+}
+
+void synthesize(const std::shared_ptr<engine>& engine_ptr, const std::string& text, client& owner)
+{
+    std::unique_ptr<document> doc = document::create_from_plain_text(engine_ptr, text.begin(), text.end(), content_text);
+    doc->set_owner(owner);
+    doc->synthesize();
+}
+
+/// Continuous reading: request paragraph, get all of its audio, play it for 30 ms, request the next one.
+/// Returns the gap from each request to its audio being ready.
+std::vector<double> read_continuously(bool pre_synthesize)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const std::shared_ptr<utterance_cache> cache = std::make_shared<utterance_cache>(1 << 24, std::string(), 0);
+    speculative_renderer renderer(2);
+    std::vector<double> gaps;
+    for(int number = 0; number < paragraph_count; ++number)
+    {
+        const std::string text = paragraph(number);
+        const std::chrono::steady_clock::time_point requested = std::chrono::steady_clock::now();
+        recording_sink sink;
+        renderer.drop_all_except(text);
+        renderer.join(text);
+        const std::shared_ptr<const recording_client> recording = cache->find(text);
+        if(recording)
+            recording->replay(sink, 0);
+        else
+            synthesize(engine_ptr, text, sink);
+        gaps.push_back(elapsed_milliseconds(requested));
+
+        if(pre_synthesize && number + 1 < paragraph_count)
+        {
+            const std::string next = paragraph(number + 1);
+            renderer.enqueue(cache, next, [engine_ptr, next](client& owner) {
+                synthesize(engine_ptr, next, owner);
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }
+    return gaps;
+}
+
+}
+
+RH_TEST(continuous_reading_gaps)
+{
+    const std::vector<double> without = read_continuously(false);
+    const std::vector<double> with = read_continuously(true);
+    /// First paragraph can't be pre-synthesized in either case
+    report_value("speculative.first_paragraph_gap", with.front(), "ms");
+    report_value("speculative.gap_without_pre_synthesis.p50", percentile(std::vector<double>(without.begin() + 1, without.end()), 0.5), "ms");
+    report_value("speculative.gap_with_pre_synthesis.p50", percentile(std::vector<double>(with.begin() + 1, with.end()), 0.5), "ms");
+    report_value("speculative.gap_with_pre_synthesis.max", percentile(std::vector<double>(with.begin() + 1, with.end()), 1), "ms");
+}
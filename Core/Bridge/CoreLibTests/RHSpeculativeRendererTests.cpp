@@ -0,0 +1,133 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <thread>
+
+#include "RHSpeculativeRenderer.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+speculative_renderer::render_function render_text(const std::shared_ptr<engine>& engine_ptr, const std::string& text)
+{
+    return [engine_ptr, text](client& owner) {
+        std::unique_ptr<document> doc = document::create_from_plain_text(engine_ptr, text.begin(), text.end(), content_text);
+        doc->set_owner(owner);
+        doc->synthesize();
+    };
+}
+
+void wait_until_empty(const speculative_renderer& renderer)
+{
+    while(!renderer.empty())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+}
+
+RH_TEST(pre_synthesized_utterance_is_served_from_cache)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const std::shared_ptr<utterance_cache> cache = std::make_shared<utterance_cache>(1 << 20, std::string(), 0);
+    const std::string text = numbered_sentences(10);
+    speculative_renderer renderer(2);
+
+    RH_CHECK(renderer.enqueue(cache, text, render_text(engine_ptr, text)));
+    RH_CHECK(!renderer.enqueue(cache, text, render_text(engine_ptr, text)));
+    wait_until_empty(renderer);
+
+    recording_sink reference;
+    render_text(engine_ptr, text)(reference);
+    renderer.drop_all_except(text);
+    renderer.join(text);
+    const std::shared_ptr<const recording_client> recording = cache->find(text);
+    RH_CHECK(recording);
+    if(!recording)
+        return;
+
+    recording_sink replayed;
+    RH_CHECK(recording->replay(replayed, 0));
+    RH_CHECK(replayed.samples == reference.samples);
+    RH_CHECK(replayed.word_positions == reference.word_positions);
+    RH_CHECK(renderer.get_statistics().completed == 1);
+}
+
+RH_TEST(request_during_rendering_waits_for_it)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const std::shared_ptr<utterance_cache> cache = std::make_shared<utterance_cache>(1 << 20, std::string(), 0);
+    const std::string text = numbered_sentences(100);
+    speculative_renderer renderer(2);
+
+    const speculative_renderer::render_function render = render_text(engine_ptr, text);
+    std::atomic<bool> started(false);
+    RH_CHECK(renderer.enqueue(cache, text, [&render, &started](client& owner) {
+        started = true;
+        render(owner);
+    }));
+    while(!started)
+        std::this_thread::yield();
+    renderer.drop_all_except(text);
+    renderer.join(text);
+
+    RH_CHECK(cache->find(text));
+    const speculative_renderer::statistics statistics = renderer.get_statistics();
+    RH_CHECK(statistics.joined == 1);
+    RH_CHECK(statistics.dropped == 0);
+}
+
+RH_TEST(mismatched_request_drops_pre_synthesis)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const std::shared_ptr<utterance_cache> cache = std::make_shared<utterance_cache>(1 << 20, std::string(), 0);
+    const std::string expected = numbered_sentences(1000);
+    const std::string other = numbered_sentences(1000) + "Other.";
+    speculative_renderer renderer(2);
+
+    RH_CHECK(renderer.enqueue(cache, expected, render_text(engine_ptr, expected)));
+    RH_CHECK(renderer.enqueue(cache, other, render_text(engine_ptr, other)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    renderer.drop_all_except("Something else.");
+    wait_until_empty(renderer);
+
+    RH_CHECK(!cache->find(expected));
+    RH_CHECK(!cache->find(other));
+    RH_CHECK(renderer.get_statistics().dropped == 2);
+}
+
+RH_TEST(cancel_all_drops_pre_synthesis)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const std::shared_ptr<utterance_cache> cache = std::make_shared<utterance_cache>(1 << 20, std::string(), 0);
+    const std::string text = numbered_sentences(1000);
+    speculative_renderer renderer(2);
+
+    RH_CHECK(renderer.enqueue(cache, text, render_text(engine_ptr, text)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    renderer.cancel_all();
+    wait_until_empty(renderer);
+
+    RH_CHECK(!cache->find(text));
+    RH_CHECK(renderer.get_statistics().dropped == 1);
+}
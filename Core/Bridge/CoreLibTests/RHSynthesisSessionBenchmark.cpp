@@ -0,0 +1,67 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <atomic>
+#include <thread>
+
+#include "core/document.hpp"
+
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+/// Independent sessions sharing one engine, each synthesizing its own utterances without a cache
+RH_TEST(session_throughput_by_thread_count)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const std::string text = numbered_sentences(40);
+    const std::size_t utterances_per_session = 4;
+    report_value("sessions.hardware_threads", std::thread::hardware_concurrency(), "threads");
+    double single = 0;
+    for(std::size_t session_count = 1; session_count <= 8; session_count *= 2)
+    {
+        std::atomic<std::size_t> samples(0);
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::vector<std::thread> sessions;
+        for(std::size_t session = 0; session < session_count; ++session)
+        {
+            sessions.push_back(std::thread([&engine_ptr, &text, &samples, utterances_per_session]() {
+                for(std::size_t utterance = 0; utterance < utterances_per_session; ++utterance)
+                {
+                    recording_sink sink;
+                    std::unique_ptr<document> doc = document::create_from_plain_text(engine_ptr, text.begin(), text.end(), content_text);
+                    doc->set_owner(sink);
+                    doc->synthesize();
+                    samples += sink.samples.size();
+                }
+            }));
+        }
+        for(std::thread& session: sessions)
+            session.join();
+
+        const double throughput = samples / elapsed_milliseconds(start);
+        if(session_count == 1)
+            single = throughput;
+        report_value("sessions." + std::to_string(session_count) + ".samples_per_ms", throughput, "samples/ms");
+        report_value("sessions." + std::to_string(session_count) + ".speedup", throughput / single, "x");
+    }
+}
@@ -0,0 +1,114 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <thread>
+
+#include "RHPCMCache.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+const std::size_t session_count = 8;
+const std::size_t text_count = 6;
+
+std::string session_text(std::size_t number)
+{
+    return numbered_sentences(3 + number) + "Text " + std::to_string(number) + ".";
+}
+
+void synthesize(const std::shared_ptr<engine>& engine_ptr, const std::string& text, client& owner)
+{
+    std::unique_ptr<document> doc = document::create_from_plain_text(engine_ptr, text.begin(), text.end(), content_text, engine_ptr->create_voice_profile("mock"));
+    doc->set_owner(owner);
+    doc->synthesize();
+}
+
+/// Same path as RHSpeechSynthesizer with a cache: replay a hit, synthesize and record a miss
+void synthesize_cached(const std::shared_ptr<engine>& engine_ptr, utterance_cache& cache, const std::string& text, client& owner)
+{
+    const std::shared_ptr<const recording_client> recording = cache.find(text);
+    if(recording)
+    {
+        recording->replay(owner, 0);
+        owner.done();
+        return;
+    }
+    caching_client caching(owner, cache, text);
+    synthesize(engine_ptr, text, caching);
+}
+
+}
+
+/// Sessions take an engine snapshot per utterance, like RHVoiceBridge, while the engine is recreated meanwhile.
+/// Run it under make tsan.
+RH_TEST(sessions_sharing_engine_and_cache_match_serial_output)
+{
+    std::vector<recording_sink> references(text_count);
+    {
+        const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+        for(std::size_t number = 0; number < text_count; ++number)
+            synthesize(engine_ptr, session_text(number), references[number]);
+    }
+
+    std::shared_ptr<engine> published = std::make_shared<engine>();
+    utterance_cache cache(1 << 22, std::string(), 0);
+    std::atomic<bool> stopping(false);
+    std::thread recreator([&published, &stopping]() {
+        while(!stopping)
+        {
+            std::atomic_store(&published, std::make_shared<engine>());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    std::atomic<std::size_t> mismatches(0);
+    std::atomic<std::size_t> finished(0);
+    std::vector<std::thread> sessions;
+    for(std::size_t session = 0; session < session_count; ++session)
+    {
+        sessions.push_back(std::thread([&, session]() {
+            for(std::size_t utterance = 0; utterance < 2 * text_count; ++utterance)
+            {
+                const std::size_t number = (session + utterance) % text_count;
+                recording_sink sink;
+                synthesize_cached(std::atomic_load(&published), cache, session_text(number), sink);
+                if(sink.samples != references[number].samples ||
+                   sink.word_positions != references[number].word_positions ||
+                   sink.sentence_positions != references[number].sentence_positions)
+                    ++mismatches;
+                finished += sink.done_count;
+            }
+        }));
+    }
+    for(std::thread& session: sessions)
+        session.join();
+    stopping = true;
+    recreator.join();
+
+    RH_CHECK(mismatches == 0);
+    RH_CHECK(finished == session_count * 2 * text_count);
+    const utterance_cache::statistics statistics = cache.get_statistics();
+    RH_CHECK(statistics.entry_count == text_count);
+    RH_CHECK(statistics.hits + statistics.misses == session_count * 2 * text_count);
+}
@@ -0,0 +1,155 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHTestSupport.h"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+namespace RHVoiceTests {
+
+namespace {
+
+struct registered_test
+{
+    const char* name;
+    test_function function;
+};
+
+std::vector<registered_test>& registered_tests()
+{
+    static std::vector<registered_test> tests;
+    return tests;
+}
+
+std::size_t failure_count = 0;
+
+}
+
+test_registration::test_registration(const char* name, test_function function)
+{
+    registered_test test = {name, function};
+    registered_tests().push_back(test);
+}
+
+void report_failure(const char* expression, const char* file, int line)
+{
+    ++failure_count;
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+}
+
+void report_value(const std::string& name, double value, const char* unit)
+{
+    std::printf("%s\t%.3f\t%s\n", name.c_str(), value, unit);
+}
+
+double elapsed_milliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+double percentile(std::vector<double> values, double fraction)
+{
+    if(values.empty())
+        return 0;
+
+    std::sort(values.begin(), values.end());
+    const std::size_t index = static_cast<std::size_t>(fraction * (values.size() - 1) + 0.5);
+    return values[index];
+}
+
+std::string numbered_sentences(std::size_t count)
+{
+    std::string text;
+    for(std::size_t index = 0; index < count; ++index)
+        text += "Word number " + std::to_string(index) + " here. ";
+    return text;
+}
+
+recording_sink::recording_sink():
+    done_count(0),
+    sample_limit(0)
+{
+}
+
+RHVoice::event_mask recording_sink::get_supported_events() const
+{
+    return RHVoice::event_audio | RHVoice::event_word_starts | RHVoice::event_sentence_starts | RHVoice::event_done;
+}
+
+bool recording_sink::sentence_starts(std::size_t position, std::size_t)
+{
+    sentence_positions.push_back(position);
+    return true;
+}
+
+bool recording_sink::word_starts(std::size_t position, std::size_t)
+{
+    word_positions.push_back(position);
+    return true;
+}
+
+bool recording_sink::play_speech(const short* samples, std::size_t count)
+{
+    this->samples.insert(this->samples.end(), samples, samples + count);
+    return sample_limit == 0 || this->samples.size() < sample_limit;
+}
+
+void recording_sink::done()
+{
+    ++done_count;
+}
+
+}
+
+/// Runs every registered test, or those whose names contain one of the arguments
+int main(int argc, char* argv[])
+{
+    using namespace RHVoiceTests;
+
+    std::size_t run_count = 0;
+    for(std::vector<registered_test>::const_iterator test = registered_tests().begin(); test != registered_tests().end(); ++test)
+    {
+        bool selected = argc < 2;
+        for(int index = 1; index < argc && !selected; ++index)
+            selected = std::strstr(test->name, argv[index]) != nullptr;
+        if(!selected)
+            continue;
+
+        const std::size_t failures_before = failure_count;
+        std::printf("[ RUN  ] %s\n", test->name);
+        std::fflush(stdout);
+        try
+        {
+            test->function();
+        }
+        catch(const std::exception& exception)
+        {
+            ++failure_count;
+            std::fprintf(stderr, "%s: exception: %s\n", test->name, exception.what());
+        }
+        std::printf("[ %s ] %s\n", failure_count == failures_before ? " OK " : "FAIL", test->name);
+        ++run_count;
+    }
+    std::printf("%zu tests, %zu failed checks\n", run_count, failure_count);
+    return failure_count == 0 ? 0 : 1;
+}
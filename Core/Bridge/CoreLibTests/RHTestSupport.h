@@ -0,0 +1,86 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHTestSupport_h
+#define RHTestSupport_h
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "core/client.hpp"
+
+namespace RHVoiceTests {
+
+typedef void (*test_function)();
+
+struct test_registration
+{
+    test_registration(const char* name, test_function function);
+};
+
+void report_failure(const char* expression, const char* file, int line);
+/// Tab separated line, so benchmark results can be compared between runs
+void report_value(const std::string& name, double value, const char* unit);
+
+/// Milliseconds since `start`
+double elapsed_milliseconds(std::chrono::steady_clock::time_point start);
+/// Value below which `fraction` of sorted `values` lie
+double percentile(std::vector<double> values, double fraction);
+/// "Word number 0 here. Word number 1 here. ..." with `count` sentences
+std::string numbered_sentences(std::size_t count);
+
+/// Records everything the engine reports, so outputs of different code paths can be compared
+class recording_sink: public RHVoice::client
+{
+public:
+    recording_sink();
+
+    RHVoice::event_mask get_supported_events() const override;
+    bool sentence_starts(std::size_t position, std::size_t length) override;
+    bool word_starts(std::size_t position, std::size_t length) override;
+    bool play_speech(const short* samples, std::size_t count) override;
+    void done() override;
+
+    std::vector<short> samples;
+    std::vector<std::size_t> word_positions;
+    std::vector<std::size_t> sentence_positions;
+    std::size_t done_count;
+    /// Stops synthesis once this many samples were received
+    std::size_t sample_limit;
+};
+
+}
+
+#define RH_TEST(name) \
+    static void name(); \
+    static RHVoiceTests::test_registration name##_registration(#name, &name); \
+    static void name()
+
+#define RH_CHECK(expression) \
+    do { \
+        if(!(expression)) \
+            RHVoiceTests::report_failure(#expression, __FILE__, __LINE__); \
+    } while(false)
+
+#endif /* RHTestSupport_h */
@@ -0,0 +1,145 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <sstream>
+#include <thread>
+
+#include <sys/resource.h>
+
+#include "RHCancellableClient.h"
+#include "RHParallelDocument.h"
+#include "RHTrace.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+double peak_resident_megabytes()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+    return usage.ru_maxrss / 1024.0;
+#endif
+}
+
+double synthesize_parallel(const std::shared_ptr<engine>& engine_ptr, const std::string& text)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::atomic<bool> cancelled(false);
+    recording_sink sink;
+    cancellable_client cancellable(sink, cancelled);
+    parallel_document_settings settings;
+    settings.thread_count = 4;
+    settings.min_piece_size = 50;
+    parallel_document doc(engine_ptr, text.data(), text.size(), settings);
+    doc.set_owner(cancellable);
+    {
+        RH_TRACE_SPAN("document.synthesize");
+        doc.synthesize();
+    }
+    return elapsed_milliseconds(start);
+}
+
+}
+
+RH_TEST(trace_span_cost)
+{
+    const int span_count = 10000;
+    trace::clear();
+    trace::set_enabled(true);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int index = 0; index < span_count; ++index)
+    {
+        RH_TRACE_SPAN("benchmark.enabled");
+    }
+    report_value("trace.span_cost.enabled", elapsed_milliseconds(start) * 1e6 / span_count, "ns");
+
+    trace::set_enabled(false);
+    start = std::chrono::steady_clock::now();
+    for(int index = 0; index < span_count * 1000; ++index)
+    {
+        RH_TRACE_SPAN("benchmark.disabled");
+    }
+    report_value("trace.span_cost.disabled", elapsed_milliseconds(start) * 1e6 / (span_count * 1000.0), "ns");
+    trace::clear();
+}
+
+/// 4-thread parallel document, every callback traced
+RH_TEST(trace_overhead_on_parallel_document)
+{
+    const std::shared_ptr<engine> engine_ptr = std::make_shared<engine>();
+    const std::string text = numbered_sentences(300);
+    double untraced = 0;
+    double traced = 0;
+    for(int run = 0; run < 5; ++run)
+    {
+        trace::set_enabled(false);
+        untraced += synthesize_parallel(engine_ptr, text);
+        trace::set_enabled(true);
+        traced += synthesize_parallel(engine_ptr, text);
+    }
+    trace::set_enabled(false);
+    std::ostringstream exported;
+    trace::write_chrome_trace(exported);
+    trace::clear();
+
+    report_value("trace.parallel_document.untraced", untraced / 5, "ms");
+    report_value("trace.parallel_document.traced", traced / 5, "ms");
+    report_value("trace.parallel_document.overhead", (traced - untraced) / untraced * 100, "%");
+    report_value("trace.export_size", exported.str().size(), "bytes");
+}
+
+/// Threads that record and exit, like parallel document workers, must reuse trace buffers
+RH_TEST(trace_memory_with_thread_churn)
+{
+    trace::clear();
+    trace::set_enabled(true);
+    double warmed_up = 0;
+    for(int round = 0; round < 300; ++round)
+    {
+        std::vector<std::thread> threads;
+        for(int index = 0; index < 4; ++index)
+        {
+            threads.push_back(std::thread([]() {
+                for(int span = 0; span < 3000; ++span)
+                {
+                    RH_TRACE_SPAN("benchmark.piece");
+                }
+            }));
+        }
+        for(std::thread& thread: threads)
+            thread.join();
+        trace::clear();
+        if(round == 20)
+            warmed_up = peak_resident_megabytes();
+    }
+    trace::set_enabled(false);
+    trace::clear();
+
+    const double growth = peak_resident_megabytes() - warmed_up;
+    report_value("trace.peak_resident_growth", growth, "MB");
+    RH_CHECK(growth < 8);
+}
@@ -0,0 +1,132 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <sstream>
+#include <thread>
+
+#include "RHTrace.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+std::string chrome_trace()
+{
+    std::ostringstream stream;
+    trace::write_chrome_trace(stream);
+    return stream.str();
+}
+
+bool contains(const std::string& text, const std::string& part)
+{
+    return text.find(part) != std::string::npos;
+}
+
+}
+
+RH_TEST(trace_exports_spans_of_finished_threads_until_clear)
+{
+    trace::clear();
+    trace::set_enabled(true);
+    std::thread([]() {
+        RH_TRACE_SPAN("test.span");
+        RH_TRACE_INSTANT("test.instant");
+    }).join();
+    {
+        RH_TRACE_SPAN("test.main");
+    }
+    trace::set_enabled(false);
+
+    const std::string exported = chrome_trace();
+    RH_CHECK(contains(exported, "\"name\":\"test.span\""));
+    RH_CHECK(contains(exported, "\"name\":\"test.instant\",\"cat\":\"RHVoice\""));
+    RH_CHECK(contains(exported, "\"ph\":\"i\""));
+    RH_CHECK(contains(exported, "\"name\":\"test.main\""));
+
+    trace::clear();
+    const std::string cleared = chrome_trace();
+    RH_CHECK(!contains(cleared, "test.span"));
+    RH_CHECK(!contains(cleared, "test.main"));
+}
+
+RH_TEST(trace_records_nothing_when_disabled)
+{
+    trace::clear();
+    {
+        RH_TRACE_SPAN("test.disabled");
+    }
+    RH_CHECK(!contains(chrome_trace(), "test.disabled"));
+}
+
+RH_TEST(trace_counts_events_past_thread_capacity_as_dropped)
+{
+    trace::clear();
+    trace::set_enabled(true);
+    std::thread([]() {
+        for(int index = 0; index < 20000; ++index)
+        {
+            RH_TRACE_SPAN("test.many");
+        }
+    }).join();
+    trace::set_enabled(false);
+
+    RH_CHECK(trace::dropped_count() == 20000 - 16384);
+    trace::clear();
+    RH_CHECK(trace::dropped_count() == 0);
+}
+
+/// Threads come and go, like parallel document workers, while another thread exports and clears
+RH_TEST(trace_clear_and_export_race_with_recording_threads)
+{
+    trace::clear();
+    trace::set_enabled(true);
+    std::atomic<bool> stopping(false);
+    std::thread clearer([&stopping]() {
+        while(!stopping)
+        {
+            chrome_trace();
+            trace::clear();
+        }
+    });
+    for(int round = 0; round < 50; ++round)
+    {
+        std::vector<std::thread> threads;
+        for(int index = 0; index < 4; ++index)
+        {
+            threads.push_back(std::thread([]() {
+                for(int span = 0; span < 2000; ++span)
+                {
+                    RH_TRACE_SPAN("test.piece");
+                }
+            }));
+        }
+        for(std::thread& thread: threads)
+            thread.join();
+    }
+    stopping = true;
+    clearer.join();
+    trace::set_enabled(false);
+    trace::clear();
+
+    RH_CHECK(!contains(chrome_trace(), "test.piece"));
+}
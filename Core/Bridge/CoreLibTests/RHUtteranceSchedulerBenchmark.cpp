@@ -0,0 +1,76 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <random>
+#include <thread>
+
+#include "RHUtteranceScheduler.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+typedef std::chrono::steady_clock test_clock;
+
+/// Synthetic load: a request every 100 us, each busy for up to 300 us unless it is cancelled.
+/// Every tenth request interrupts, a third of the rest are background pre-renders.
+/// Reports time from `submit` to the task starting, per priority.
+RH_TEST(scheduler_queueing_latency_under_load)
+{
+    const int request_count = 2000;
+    const char* const priority_names[] = {"background", "normal", "interrupt"};
+
+    utterance_scheduler scheduler;
+    std::mutex mutex;
+    std::vector<double> latencies[3];
+    std::mt19937 random(1);
+    for(int index = 0; index < request_count; ++index)
+    {
+        const utterance_priority priority = index % 10 == 0 ? utterance_priority_interrupt : (index % 3 == 0 ? utterance_priority_background : utterance_priority_normal);
+        const std::chrono::microseconds work(random() % 300);
+        const test_clock::time_point submitted = test_clock::now();
+        scheduler.submit(priority, [&mutex, &latencies, priority, work, submitted](const std::atomic<bool>& cancelled) {
+            const test_clock::time_point started = test_clock::now();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                latencies[priority].push_back(std::chrono::duration<double, std::micro>(started - submitted).count());
+            }
+            while(!cancelled && test_clock::now() < started + work)
+            {
+            }
+        }, utterance_scheduler::cancel_function());
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    scheduler.wait_until_idle();
+
+    for(int priority = 0; priority < 3; ++priority)
+    {
+        const std::string name = std::string("scheduler.queueing_latency.") + priority_names[priority];
+        report_value(name + ".p50", percentile(latencies[priority], 0.5), "us");
+        report_value(name + ".p90", percentile(latencies[priority], 0.9), "us");
+        report_value(name + ".p99", percentile(latencies[priority], 0.99), "us");
+    }
+    const utterance_scheduler::statistics statistics = scheduler.get_statistics();
+    report_value("scheduler.completed", statistics.completed, "tasks");
+    report_value("scheduler.cancelled_while_running", statistics.cancelled_while_running, "tasks");
+    report_value("scheduler.cancelled_before_start", statistics.cancelled_before_start, "tasks");
+    RH_CHECK(statistics.completed + statistics.cancelled_while_running + statistics.cancelled_before_start == static_cast<std::uint64_t>(request_count));
+}
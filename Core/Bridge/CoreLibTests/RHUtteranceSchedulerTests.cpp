@@ -0,0 +1,173 @@
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <thread>
+
+#include "RHPCMRingBuffer.h"
+#include "RHUtteranceScheduler.h"
+#include "RHTestSupport.h"
+
+using namespace RHVoice;
+using namespace RHVoiceTests;
+
+namespace {
+
+/// Results of finished tasks: task number, negative if it was cancelled
+class task_log
+{
+public:
+    utterance_scheduler::task_function task(int number)
+    {
+        return [this, number](const std::atomic<bool>& cancelled) {
+            add(cancelled ? -number : number);
+        };
+    }
+
+    void add(int value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        values.push_back(value);
+    }
+
+    std::vector<int> get() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return values;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::vector<int> values;
+};
+
+void wait_for(const std::atomic<bool>& flag)
+{
+    while(!flag)
+        std::this_thread::yield();
+}
+
+}
+
+RH_TEST(scheduler_runs_higher_priority_first_and_fifo_within_priority)
+{
+    utterance_scheduler scheduler;
+    task_log log;
+    std::atomic<bool> started(false);
+    std::atomic<bool> released(false);
+    scheduler.submit(utterance_priority_normal, [&started, &released, &log](const std::atomic<bool>&) {
+        started = true;
+        wait_for(released);
+        log.add(0);
+    }, utterance_scheduler::cancel_function());
+    wait_for(started);
+
+    for(int number = 1; number <= 3; ++number)
+        scheduler.submit(utterance_priority_background, log.task(number), utterance_scheduler::cancel_function());
+    for(int number = 4; number <= 6; ++number)
+        scheduler.submit(utterance_priority_normal, log.task(number), utterance_scheduler::cancel_function());
+    released = true;
+    scheduler.wait_until_idle();
+
+    const int expected[] = {0, 4, 5, 6, 1, 2, 3};
+    RH_CHECK(log.get() == std::vector<int>(expected, expected + 7));
+}
+
+RH_TEST(scheduler_preempts_lower_priority_and_interrupt_cancels_pending)
+{
+    utterance_scheduler scheduler;
+    task_log log;
+    std::atomic<bool> background_started(false);
+    std::atomic<bool> background_stopped(false);
+    scheduler.submit(utterance_priority_background, [&](const std::atomic<bool>& cancelled) {
+        background_started = true;
+        wait_for(background_stopped);
+        log.add(cancelled ? -1 : 1);
+    }, [&background_stopped]() {
+        background_stopped = true;
+    });
+    wait_for(background_started);
+
+    std::atomic<bool> normal_started(false);
+    std::atomic<bool> normal_stopped(false);
+    scheduler.submit(utterance_priority_normal, [&](const std::atomic<bool>& cancelled) {
+        normal_started = true;
+        wait_for(normal_stopped);
+        log.add(cancelled ? -2 : 2);
+    }, [&normal_stopped]() {
+        normal_stopped = true;
+    });
+    scheduler.submit(utterance_priority_normal, log.task(3), utterance_scheduler::cancel_function());
+    wait_for(normal_started);
+    scheduler.submit(utterance_priority_interrupt, log.task(4), utterance_scheduler::cancel_function());
+    scheduler.wait_until_idle();
+
+    /// Cancelled pending task reports first, then the interrupt runs
+    const int expected[] = {-1, -2, -3, 4};
+    RH_CHECK(log.get() == std::vector<int>(expected, expected + 4));
+    const utterance_scheduler::statistics statistics = scheduler.get_statistics();
+    RH_CHECK(statistics.completed == 1);
+    RH_CHECK(statistics.cancelled_while_running == 2);
+    RH_CHECK(statistics.cancelled_before_start == 1);
+}
+
+/// Cancel hook of a preempted task may run after the task returned. It has to reach that task's own buffer only.
+RH_TEST(scheduler_cancel_hook_only_cancels_its_own_task)
+{
+    utterance_scheduler scheduler;
+    std::atomic<bool> first_started(false);
+    std::shared_ptr<pcm_ring_buffer> first_buffer = std::make_shared<pcm_ring_buffer>(16);
+    scheduler.submit(utterance_priority_normal, [&first_started, first_buffer](const std::atomic<bool>&) {
+        first_started = true;
+        while(!first_buffer->is_cancelled())
+            std::this_thread::yield();
+    }, [first_buffer]() {
+        first_buffer->cancel();
+    });
+    wait_for(first_started);
+
+    std::shared_ptr<pcm_ring_buffer> second_buffer = std::make_shared<pcm_ring_buffer>(16);
+    std::atomic<bool> second_cancelled(false);
+    scheduler.submit(utterance_priority_interrupt, [second_buffer, &second_cancelled](const std::atomic<bool>& cancelled) {
+        second_cancelled = cancelled || second_buffer->is_cancelled();
+    }, [second_buffer]() {
+        second_buffer->cancel();
+    });
+    scheduler.wait_until_idle();
+
+    RH_CHECK(first_buffer->is_cancelled());
+    RH_CHECK(!second_buffer->is_cancelled());
+    RH_CHECK(!second_cancelled);
+}
+
+RH_TEST(scheduler_can_be_destroyed_from_its_task)
+{
+    utterance_scheduler* scheduler = new utterance_scheduler();
+    std::atomic<bool> submitted(false);
+    std::atomic<bool> destroyed(false);
+    scheduler->submit(utterance_priority_normal, [&](const std::atomic<bool>&) {
+        wait_for(submitted);
+        delete scheduler;
+        destroyed = true;
+    }, utterance_scheduler::cancel_function());
+    submitted = true;
+    wait_for(destroyed);
+    RH_CHECK(destroyed);
+}
@@ -29,13 +29,22 @@
 #define RHEventLoggerImpl_hpp
 
 #include <stdio.h>
+#include <memory>
 
 #include "core/event_logger.hpp"
+#include "RHAsyncLogger.h"
 
+/// Messages below `minLevel` are dropped on the calling thread, the rest are forwarded to `RHVoiceLogger` on a background thread
 class RHEventLoggerImpl : public RHVoice::event_logger
 {
 public:
+    explicit RHEventLoggerImpl(RHVoice_log_level minLevel = RHVoice_log_level_trace);
     void log(const std::string& tag, RHVoice_log_level level, const std::string& message) const override;
+    /// Takes effect for messages logged after the call, also on other threads
+    void set_min_level(RHVoice_log_level minLevel);
+
+private:
+    std::unique_ptr<RHVoice::async_logger> queue;
 };
 
 #endif /* RHeventLoggerImpl_hpp */
@@ -30,10 +30,32 @@
 #import "RHVoiceLogger.h"
 #import "NSString+stdStringAddtitons.h"
 
+namespace {
+    const std::size_t RHEventLoggerQueueCapacity = 256;
+
+    NSString *RHLogString(const char *bytes, std::size_t size) {
+        NSString *result = [[NSString alloc] initWithBytes:bytes length:size encoding:NSUTF8StringEncoding];
+        /// Truncation could have cut a multibyte character
+        return result ?: [[NSString alloc] initWithBytes:bytes length:size encoding:NSISOLatin1StringEncoding];
+    }
+}
+
+RHEventLoggerImpl::RHEventLoggerImpl(RHVoice_log_level minLevel):
+    queue(new RHVoice::async_logger(RHEventLoggerQueueCapacity, minLevel, [](int level, const char *tag, std::size_t tagSize, const char *message, std::size_t messageSize) {
+        @autoreleasepool {
+            NSString *nsTag = RHLogString(tag, tagSize);
+            NSString *nsMessage = RHLogString(message, messageSize);
+
+            [RHVoiceLogger logAtRHVoiceLevel:static_cast<RHVoice_log_level>(level) message:[[NSString alloc] initWithFormat:@"%@ %@",nsTag, nsMessage]];
+        }
+    }))
+{
+}
+
 void RHEventLoggerImpl::log(const std::string& tag, RHVoice_log_level level, const std::string& message) const {
-    
-    NSString *nsTag = STDStringToNSString(tag);
-    NSString *nsMessage = STDStringToNSString(message);
-    
-    [RHVoiceLogger logAtRHVoiceLevel:level message:[[NSString alloc] initWithFormat:@"%@ %@",nsTag, nsMessage]];
+    queue->log(level, tag.data(), tag.size(), message.data(), message.size());
+}
+
+void RHEventLoggerImpl::set_min_level(RHVoice_log_level minLevel) {
+    queue->set_min_level(minLevel);
 }
@@ -0,0 +1,38 @@
+//
+//  RHSpeechTextStream+Private.h
+//  RHVoice
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHSpeechTextStream_Private_h
+#define RHSpeechTextStream_Private_h
+
+#import "RHSpeechTextStream.h"
+
+#include <memory>
+
+#include "RHIncrementalDocument.h"
+
+@interface RHSpeechTextStream (Private)
+- (std::shared_ptr<RHVoice::incremental_text>)rhVoiceText;
+@end
+
+#endif /* RHSpeechTextStream_Private_h */
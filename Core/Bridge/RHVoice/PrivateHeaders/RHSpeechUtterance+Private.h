@@ -32,8 +32,29 @@
 #include "core/quality_setting.hpp"
 #include "core/document.hpp"
 
+#include "RHParallelDocument.h"
+#include "RHIncrementalDocument.h"
+#include "RHUTF16OffsetIndex.h"
+
 @interface RHSpeechUtterance (Private)
+/// Text utterance was created with using `initWithText:`, nil for SSML utterances
+- (NSString *)plainText;
+/// Plain text utterances are passed to engine as is, without `<speak>` wrapping and SSML parsing
 - (std::unique_ptr<RHVoice::document>)rhVoiceDocument;
+/// Same as `rhVoiceDocument`, synthesized at `volume` instead of utterance volume
+- (std::unique_ptr<RHVoice::document>)rhVoiceDocumentWithVolume:(double)volume;
+/// Maps marker positions reported by engine to UTF-16 offsets in the text engine got. Built once per utterance
+- (std::shared_ptr<const RHVoice::utf16_offset_index>)rhVoiceOffsetIndex;
+/// Has to be added to marker locations to make them point to `ssml`
+- (NSUInteger)rhVoiceMarkerLocationOffset;
+/// Everything that affects synthesized audio and markers, except volume. Cached audio is scaled to utterance volume on replay
+- (std::string)rhVoiceCacheKey;
+/// Only for plain text utterances. Utterance and `cancellation` have to outlive returned document
+- (std::unique_ptr<RHVoice::parallel_document>)rhVoiceParallelDocumentWithThreadCount:(NSUInteger)threadCount
+                                                                                volume:(double)volume
+                                                                          cancellation:(const std::atomic<bool> *)cancellation;
+/// Only for utterances with `textStream`. `cancellation` has to outlive returned document
+- (std::unique_ptr<RHVoice::incremental_document>)rhVoiceIncrementalDocumentWithCancellation:(const std::atomic<bool> *)cancellation;
 @end
 
 #endif /* RHSpeechUtterance_Private_h */
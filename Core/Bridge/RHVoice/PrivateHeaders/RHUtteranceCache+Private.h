@@ -0,0 +1,39 @@
+//
+//  RHUtteranceCache+Private.h
+//  RHVoice
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+
+#ifndef RHUtteranceCache_Private_h
+#define RHUtteranceCache_Private_h
+
+#import "RHUtteranceCache.h"
+
+#include <memory>
+
+#include "RHPCMCache.h"
+
+@interface RHUtteranceCache (Private)
+- (std::shared_ptr<RHVoice::utterance_cache>)cache;
+@end
+
+#endif /* RHUtteranceCache_Private_h */
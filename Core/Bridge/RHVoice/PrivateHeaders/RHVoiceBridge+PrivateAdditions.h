@@ -35,6 +35,8 @@
 @interface RHVoiceBridge(private_additions)
 - (const RHVoice::voice_list &)voices;
 - (std::shared_ptr<RHVoice::engine>)engine;
+/// Changes every time engine is created, so results of different engines can be told apart
+- (NSUInteger)engineGeneration;
 @end
 
 #endif /* RHVoiceBridge_Private_h */
@@ -11,10 +11,11 @@
 
 #import "RHVoiceBridgeParams.h"
 
-#include "core/event_logger.hpp"
+#include "RHEventLoggerImpl.hpp"
 
 @interface RHVoiceBridgeParams(private_additions)
-- (std::shared_ptr<RHVoice::event_logger>)rhLogger;
+- (std::shared_ptr<RHEventLoggerImpl>)rhLogger;
++ (RHVoice_log_level)internalLogLevel:(RHVoiceLogLevel)level;
 @end
 
 #endif /* RHVoiceBridge_Private_h */
@@ -0,0 +1,51 @@
+//
+//  RHAudioRingBuffer.h
+//  RHVoice
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Fixed capacity single-producer/single-consumer buffer of synthesized samples.
+/// Reading never blocks, locks or allocates so it is safe to call from a render callback.
+@interface RHAudioRingBuffer : NSObject
+@property (nonatomic, readonly) NSInteger capacity;
+@property (nonatomic, readonly) NSInteger availableFrames;
+@property (nonatomic, readonly) BOOL isFinished;
+@property (nonatomic, readonly) BOOL isDrained;
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithCapacity:(NSInteger)capacity;
+
+/// Blocks while the buffer is full. Returns NO if the buffer was cancelled.
+- (BOOL)writeSamples:(const short *)samples count:(NSInteger)count;
+/// Sleeps until at least `count` frames are available, writer finished or `timeout` expired.
+/// Returns number of available frames.
+- (NSInteger)waitForFrames:(NSInteger)count timeout:(NSTimeInterval)timeout;
+/// Converts samples to float32 in [-1, 1) while copying them to `frames`. Returns number of copied frames.
+- (NSInteger)readFrames:(float *)frames count:(NSInteger)count;
+- (void)finish;
+- (void)cancel;
+@end
+
+NS_ASSUME_NONNULL_END
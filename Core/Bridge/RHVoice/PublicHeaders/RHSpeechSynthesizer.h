@@ -28,6 +28,16 @@
 #import <Foundation/Foundation.h>
 
 #import "RHSpeechUtterance.h"
+#import "RHUtteranceCache.h"
+
+typedef enum RHSpeechAudioFileFormat : NSInteger {
+    /// Uncompressed 16 bit PCM
+    RHSpeechAudioFileFormatWAV,
+    /// Lossless, in FLAC container
+    RHSpeechAudioFileFormatFLAC,
+    /// In CAF container, since Ogg is not supported by system encoders
+    RHSpeechAudioFileFormatOpus
+} RHSpeechAudioFileFormat;
 
 @class RHSpeechSynthesizer;
 @class RHSpeechUtteranceClient;
@@ -42,19 +52,44 @@
 @optional
 - (void)speechSynthesizer:(RHSpeechSynthesizer *_Nonnull)speechSynthesizer
      didBeginSynthesizing:(RHSpeechUtterance *_Nonnull)utterance;
+- (void)speechSynthesizer:(RHSpeechSynthesizer *_Nonnull)speechSynthesizer
+         didStartSpeaking:(RHSpeechUtterance *_Nonnull)utterance;
 @end
 
 NS_ASSUME_NONNULL_BEGIN
 
+/// Every synthesizer is an independent session: it has its own queue and synthesis state and shares only
+/// read-only voice and language data of the engine. Several synthesizers can synthesize at the same time.
+/// Each utterance keeps the engine it started with, even if `RHVoiceBridge` recreates the engine meanwhile.
 @interface RHSpeechSynthesizer : NSObject
 @property (nonatomic, weak) id<RHSpeechSynthesizerDelegate> delegate;
 @property (nonatomic, readonly) BOOL isSpeaking;
+/// Number of threads used to synthesize plain text utterances sentence by sentence. Default is 1.
+/// Values greater than 1 split long texts at sentence boundaries and synthesize pieces in parallel,
+/// audio and markers are still delivered in text order.
+@property (atomic, assign) NSUInteger parallelSynthesisThreadCount;
+/// When set, utterances found in cache are replayed without running the engine,
+/// and fully synthesized ones are added to it. Default is nil.
+@property (atomic, strong, nullable) RHUtteranceCache *utteranceCache;
 - (void)speak:(RHSpeechUtterance *)utterance;
 - (void)synthesizeUtterance:(RHSpeechUtterance *)utterance
                toFileAtPath:(NSString *)path;
+/// Audio is encoded and written on a separate thread while synthesis goes on
+- (void)synthesizeUtterance:(RHSpeechUtterance *)utterance
+               toFileAtPath:(NSString *)path
+                     format:(RHSpeechAudioFileFormat)format;
 - (void)synthesizeUtterance:(RHSpeechUtterance *)utterance
                      client:(RHSpeechUtteranceClient *)client;
 - (void)stopAndCancel;
+/// Renders `utterance` on a low priority thread into `utteranceCache`, so the following request for the same
+/// utterance is replayed without waiting for engine, e.g. the next paragraph during continuous reading.
+/// Pre-rendering is dropped when a different utterance is requested or on `stopAndCancel`.
+/// Does nothing if `utteranceCache` is nil.
+- (void)preSynthesizeUtterance:(RHSpeechUtterance *)utterance;
+/// Loads data of `voice` on a background queue, so the first utterance does not pay for it.
+/// Loaded voices stay in engine until it is recreated.
+- (void)prewarmVoice:(RHSpeechSynthesisVoice *)voice
+          completion:(void (^ _Nullable)(void))completion;
 @end
 
 NS_ASSUME_NONNULL_END
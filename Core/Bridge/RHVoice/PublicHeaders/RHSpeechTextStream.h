@@ -0,0 +1,41 @@
+//
+//  RHSpeechTextStream.h
+//  RHVoice
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Text that is still being produced, e.g. live captions or generated text.
+/// Utterance created with `-[RHSpeechUtterance initWithTextStream:]` starts speaking as soon as
+/// the first sentence is complete, without waiting for the rest.
+/// Word and sentence markers of such utterances have `NSNotFound` text ranges.
+@interface RHSpeechTextStream : NSObject
+@property (nonatomic, readonly) BOOL isFinished;
+/// Can be called from any thread. Text appended after `finish` is ignored.
+- (void)appendText:(NSString *)text;
+/// No more text will be appended. The unfinished last sentence is spoken and utterance finishes.
+- (void)finish;
+@end
+
+NS_ASSUME_NONNULL_END
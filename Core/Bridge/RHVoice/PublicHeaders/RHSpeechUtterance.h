@@ -28,6 +28,7 @@
 #import <Foundation/Foundation.h>
 
 #import "RHSpeechSynthesisVoice.h"
+#import "RHSpeechTextStream.h"
 
 typedef enum RHSpeechUtteranceQuality : NSInteger {
     RHSpeechUtteranceQualityMin,
@@ -35,19 +36,33 @@ typedef enum RHSpeechUtteranceQuality : NSInteger {
     RHSpeechUtteranceQualityMax
 } RHSpeechUtteranceQuality;
 
+typedef enum RHSpeechUtterancePriority : NSInteger {
+    /// Pre-rendering of likely next utterances. Preempted by any other utterance
+    RHSpeechUtterancePriorityBackground,
+    RHSpeechUtterancePriorityNormal,
+    /// Preempts running utterance of lower priority and drops queued ones
+    RHSpeechUtterancePriorityInterrupt
+} RHSpeechUtterancePriority;
+
 NS_ASSUME_NONNULL_BEGIN
 
 @interface RHSpeechUtterance : NSObject
 @property (nonatomic, strong, nullable, readonly) NSString *ssml;
+/// Set for utterances created with `initWithTextStream:`
+@property (nonatomic, strong, nullable, readonly) RHSpeechTextStream *textStream;
 @property (nonatomic, readonly) BOOL isEmpty;
 @property (nonatomic, strong, nullable) RHSpeechSynthesisVoice *voice;
 @property (nonatomic, strong, nullable) NSString *voiceProfile;
 @property (nonatomic, assign) double rate;
 @property (nonatomic, assign) double volume;
 @property (nonatomic, assign) RHSpeechUtteranceQuality quality;
+/// Order in which `RHSpeechSynthesizer` processes queued utterances. Default is `RHSpeechUtterancePriorityNormal`.
+@property (nonatomic, assign) RHSpeechUtterancePriority priority;
 
 - (instancetype)initWithText:(NSString * _Nullable)text;
 - (instancetype)initWithSSML:(NSString * _Nullable)ssml;
+/// Plain text that is appended to `textStream` while utterance is being spoken. Such utterances are not cached.
+- (instancetype)initWithTextStream:(RHSpeechTextStream *)textStream;
 @end
 
 NS_ASSUME_NONNULL_END
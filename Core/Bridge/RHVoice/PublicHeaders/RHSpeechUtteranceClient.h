@@ -9,9 +9,12 @@
 
 @class RHSpeechSynthesisMarker;
 @class RHSpeechUtteranceClient;
+@class RHAudioRingBuffer;
 
 @protocol RHSpeechUtteranceClientMarkerDelegate <NSObject>
 - (void)utteranceClientDidReceiveMarkers:(NSArray<RHSpeechSynthesisMarker *> *_Nonnull)markers;
+@optional
+/// Not called for clients created with `audioRingBufferCapacity`. Samples should be read from `audioRingBuffer` instead.
 - (void)utteranceClientDidReceiveSamples:(const short* _Nonnull)samples withSize:(NSInteger)count;
 @end
 
@@ -28,11 +31,19 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface RHSpeechUtteranceClient : NSObject
 @property (nonatomic, weak, nullable) id<RHSpeechUtteranceClientMarkerDelegate> markerDelegate;
+@property (nonatomic, strong, readonly, nullable) RHAudioRingBuffer *audioRingBuffer;
 - (instancetype)initWithAudioBufferSize:(int)audioBufferSize;
+/// Synthesized samples are written to `audioRingBuffer` instead of being passed to `markerDelegate`.
+/// Synthesis is paused while the buffer is full, so consumer has to keep reading from it.
+- (instancetype)initWithAudioBufferSize:(int)audioBufferSize
+                audioRingBufferCapacity:(NSInteger)audioRingBufferCapacity;
 - (RHSpeechUtteranceClientStatus)status;
 - (BOOL)completed;
 - (BOOL)isRendering;
 - (void)cancel;
+/// Sleeps until `audioRingBuffer` has at least `frameCount` frames, synthesis is done or `timeout` expired.
+/// Returns number of frames available for reading. Returns 0 immediately for clients without `audioRingBuffer`.
+- (NSInteger)waitForFrames:(NSInteger)frameCount timeout:(NSTimeInterval)timeout;
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,53 @@
+//
+//  RHUtteranceCache.h
+//  RHVoice
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Keeps synthesized audio and markers of recent utterances, so repeated short strings
+/// (e.g. "button", menu items) are replayed without running the engine again.
+/// Key includes SSML, voice, profile, rate and quality. Audio is kept at volume 1 and scaled on replay,
+/// so the same text at another volume is a hit. One cache can be shared by several synthesizers.
+@interface RHUtteranceCache : NSObject
+@property (nonatomic, readonly) NSUInteger hitCount;
+/// Part of `hitCount` that was served from disk
+@property (nonatomic, readonly) NSUInteger diskHitCount;
+@property (nonatomic, readonly) NSUInteger missCount;
+@property (nonatomic, readonly) NSUInteger memoryBytes;
+@property (nonatomic, readonly) NSUInteger diskBytes;
+@property (nonatomic, readonly) NSUInteger entryCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+/// Memory only cache
+- (instancetype)initWithMemoryCapacity:(NSUInteger)memoryCapacity;
+/// Entries evicted from memory are kept in a folder inside `RHTemporaryFolderPath` until `diskCapacity` is reached.
+/// Pass 0 as `diskCapacity` to disable disk tier.
+- (instancetype)initWithMemoryCapacity:(NSUInteger)memoryCapacity
+                          diskCapacity:(NSUInteger)diskCapacity;
+- (void)removeAllEntries;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -32,6 +32,9 @@
 #import <RHSpeechSynthesizer.h>
 #import <RHSpeechSynthesisVoice.h>
 #import <RHSpeechUtteranceClient.h>
+#import <RHAudioRingBuffer.h>
+#import <RHUtteranceCache.h>
+#import <RHSpeechTextStream.h>
 #import <RHSpeechSynthesisMarker.h>
 #import <RHLanguage.h>
 #import <RHVersionInfo.h>
@@ -32,6 +32,16 @@
 - (NSString *)packagesJSON;
 - (NSString *)cachedPackagesJSON;
 - (void)recreateEngine;
+/// Recreates engine only if voices or languages were installed, removed or updated since engine was created.
+/// Returns YES if engine was recreated.
+- (BOOL)recreateEngineIfDataChanged;
+/// Changes `params.minimumLogLevel` and applies it to the current engine's logger without recreating the engine
+- (void)setMinimumLogLevel:(RHVoiceLogLevel)level;
+/// Records timing of synthesis stages and engine callbacks on every thread. Default is NO.
+- (void)setTracingEnabled:(BOOL)enabled;
+/// Writes spans recorded since the last call in Chrome trace format, can be opened in Perfetto.
+/// Tracing is paused while writing. Returns NO if file can not be written.
+- (BOOL)writeTraceToPath:(NSString *)path;
 @end
 
 #endif /* RHVoiceBridge_Private_h */
@@ -36,6 +36,8 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, strong, nonnull) NSString *dataPath;
 @property (nonatomic, strong, nonnull) NSString *configPath;
 @property (nonatomic, strong, nonnull) NSString *pkgPath;
+/// Engine messages below this level are discarded before reaching `logger`. Default is `RHVoiceLogLevelTrace`.
+@property (nonatomic, assign) RHVoiceLogLevel minimumLogLevel;
 + (instancetype)defaultParams;
 @end
 
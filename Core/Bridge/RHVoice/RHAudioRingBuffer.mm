@@ -0,0 +1,93 @@
+//
+//  RHAudioRingBuffer.mm
+//  RHVoice
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#import "RHAudioRingBuffer.h"
+#import "RHAudioRingBuffer+Private.h"
+
+@interface RHAudioRingBuffer () {
+    std::shared_ptr<RHVoice::pcm_ring_buffer> buffer;
+}
+@end
+
+@implementation RHAudioRingBuffer
+
+- (instancetype)initWithCapacity:(NSInteger)capacity {
+    self = [super init];
+    if (self) {
+        buffer = std::make_shared<RHVoice::pcm_ring_buffer>(static_cast<std::size_t>(MAX(capacity, 0)));
+    }
+    return self;
+}
+
+- (NSInteger)capacity {
+    return buffer->capacity();
+}
+
+- (NSInteger)availableFrames {
+    return buffer->size();
+}
+
+- (BOOL)isFinished {
+    return buffer->is_finished();
+}
+
+- (BOOL)isDrained {
+    return buffer->is_drained();
+}
+
+- (BOOL)writeSamples:(const short *)samples count:(NSInteger)count {
+    if(count <= 0) {
+        return !buffer->is_cancelled();
+    }
+    return buffer->write(samples, count);
+}
+
+- (NSInteger)readFrames:(float *)frames count:(NSInteger)count {
+    if(count <= 0) {
+        return 0;
+    }
+    return buffer->read(frames, count);
+}
+
+- (NSInteger)waitForFrames:(NSInteger)count timeout:(NSTimeInterval)timeout {
+    const auto duration = std::chrono::duration<double>(MAX(timeout, 0));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration);
+    return buffer->wait_for_frames(static_cast<std::size_t>(MAX(count, 0)), deadline);
+}
+
+- (void)finish {
+    buffer->finish();
+}
+
+- (void)cancel {
+    buffer->cancel();
+}
+
+#pragma mark - Private
+
+- (std::shared_ptr<RHVoice::pcm_ring_buffer>)buffer {
+    return buffer;
+}
+
+@end
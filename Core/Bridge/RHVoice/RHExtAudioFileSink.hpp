@@ -0,0 +1,58 @@
+//
+//  RHExtAudioFileSink.hpp
+//  RHVoice
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef RHExtAudioFileSink_hpp
+#define RHExtAudioFileSink_hpp
+
+#include <string>
+
+#include <AudioToolbox/AudioToolbox.h>
+
+#include "RHBufferedFileClient.h"
+
+/// Encodes 16 bit mono samples with `ExtAudioFile`, e.g. to FLAC or Opus.
+/// Encoding happens inside `write`, so it is meant to be driven by `buffered_file_client`.
+class RHExtAudioFileSink : public RHVoice::audio_file_sink
+{
+public:
+    RHExtAudioFileSink(const std::string& path, AudioFileTypeID fileType, AudioFormatID formatID, double sampleRate);
+    ~RHExtAudioFileSink();
+    bool write(const short* samples, std::size_t count) override;
+    bool finish() override;
+
+private:
+    bool open();
+
+    const std::string path;
+    const AudioFileTypeID fileType;
+    const AudioFormatID formatID;
+    const double sampleRate;
+    ExtAudioFileRef file;
+    bool failed;
+
+    RHExtAudioFileSink(const RHExtAudioFileSink&);
+    RHExtAudioFileSink& operator=(const RHExtAudioFileSink&);
+};
+
+#endif /* RHExtAudioFileSink_hpp */
@@ -0,0 +1,133 @@
+//
+//  RHExtAudioFileSink.mm
+//  RHVoice
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "RHExtAudioFileSink.hpp"
+
+#import <Foundation/Foundation.h>
+
+#import "RHVoiceLogger.h"
+#import "NSString+stdStringAddtitons.h"
+
+RHExtAudioFileSink::RHExtAudioFileSink(const std::string& path, AudioFileTypeID fileType, AudioFormatID formatID, double sampleRate) :
+    path(path),
+    fileType(fileType),
+    formatID(formatID),
+    sampleRate(sampleRate),
+    file(NULL),
+    failed(false) {
+}
+
+RHExtAudioFileSink::~RHExtAudioFileSink() {
+    if(file != NULL) {
+        ExtAudioFileDispose(file);
+    }
+}
+
+bool RHExtAudioFileSink::open() {
+    AudioStreamBasicDescription clientFormat = {};
+    clientFormat.mSampleRate = sampleRate;
+    clientFormat.mFormatID = kAudioFormatLinearPCM;
+    clientFormat.mFormatFlags = kAudioFormatFlagIsSignedInteger | kAudioFormatFlagIsPacked;
+    clientFormat.mChannelsPerFrame = 1;
+    clientFormat.mBitsPerChannel = 16;
+    clientFormat.mFramesPerPacket = 1;
+    clientFormat.mBytesPerFrame = sizeof(short);
+    clientFormat.mBytesPerPacket = sizeof(short);
+
+    AudioStreamBasicDescription fileFormat = {};
+    if(formatID == kAudioFormatLinearPCM) {
+        fileFormat = clientFormat;
+    } else {
+        fileFormat.mSampleRate = sampleRate;
+        fileFormat.mFormatID = formatID;
+        fileFormat.mChannelsPerFrame = 1;
+        if(formatID == kAudioFormatFLAC) {
+            fileFormat.mFormatFlags = kAppleLosslessFormatFlag_16BitSourceData;
+        }
+        UInt32 size = sizeof(fileFormat);
+        OSStatus status = AudioFormatGetProperty(kAudioFormatProperty_FormatInfo, 0, NULL, &size, &fileFormat);
+        if(status != noErr) {
+            [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"Audio format %u is not supported. Status:%d", (unsigned int)formatID, (int)status];
+            return false;
+        }
+        if(formatID == kAudioFormatOpus && fileFormat.mFramesPerPacket == 0) {
+            /// 20 ms packets
+            fileFormat.mFramesPerPacket = (UInt32)(sampleRate / 50);
+        }
+    }
+
+    NSURL *url = [NSURL fileURLWithPath:STDStringToNSString(path)];
+    OSStatus status = ExtAudioFileCreateWithURL((__bridge CFURLRef)url, fileType, &fileFormat, NULL, kAudioFileFlags_EraseFile, &file);
+    if(status != noErr) {
+        [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"Failed to create audio file at %@. Status:%d", url.path, (int)status];
+        file = NULL;
+        return false;
+    }
+
+    status = ExtAudioFileSetProperty(file, kExtAudioFileProperty_ClientDataFormat, sizeof(clientFormat), &clientFormat);
+    if(status != noErr) {
+        [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"Failed to set up encoder for %@. Status:%d", url.path, (int)status];
+        return false;
+    }
+    return true;
+}
+
+bool RHExtAudioFileSink::write(const short* samples, std::size_t count) {
+    if(failed) {
+        return false;
+    }
+    if(file == NULL && !open()) {
+        failed = true;
+        return false;
+    }
+
+    AudioBufferList bufferList;
+    bufferList.mNumberBuffers = 1;
+    bufferList.mBuffers[0].mNumberChannels = 1;
+    bufferList.mBuffers[0].mDataByteSize = (UInt32)(count * sizeof(short));
+    bufferList.mBuffers[0].mData = const_cast<short *>(samples);
+
+    OSStatus status = ExtAudioFileWrite(file, (UInt32)count, &bufferList);
+    if(status != noErr) {
+        [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"Failed to write audio file. Status:%d", (int)status];
+        failed = true;
+    }
+    return !failed;
+}
+
+bool RHExtAudioFileSink::finish() {
+    if(file == NULL && !failed && !open()) {
+        failed = true;
+    }
+    if(file != NULL) {
+        /// Flushes encoder and writes headers
+        OSStatus status = ExtAudioFileDispose(file);
+        file = NULL;
+        if(status != noErr) {
+            [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"Failed to finish audio file. Status:%d", (int)status];
+            failed = true;
+        }
+    }
+    return !failed;
+}
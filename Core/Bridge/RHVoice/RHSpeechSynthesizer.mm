@@ -28,15 +28,22 @@
 #import "RHSpeechSynthesizer.h"
 
 #import <AVFAudio/AVFAudio.h>
+#include <pthread.h>
 
 #include "RHSpeechUtterance+Private.h"
 #import "RHSpeechUtteranceClient+Private.h"
+#import "RHUtteranceCache+Private.h"
 
-#import "NSString+Additions.h"
-#import "NSFileManager+Additions.h"
 #import "NSString+stdStringAddtitons.h"
 
 #include "RHVoiceWrapper.h"
+#include "RHBufferedFileClient.h"
+#include "RHExtAudioFileSink.hpp"
+#include "RHUtteranceScheduler.h"
+#include "RHCancellableClient.h"
+#include "RHGainClient.h"
+#include "RHSpeculativeRenderer.h"
+#include "RHTrace.h"
 #import "RHVoiceLogger.h"
 
 #define CALLDELEGATE_WITH_ERROR_IF_NEEDED_AND_EXIT(errorObject) \
@@ -45,14 +52,51 @@
         return; \
     }
 
-@interface RHSpeechSynthesizer() <AVAudioPlayerDelegate,
-                                  RHSpeechUtteranceClientPrivateDelegate> {
+static const double RHStreamingSampleRate = 24000.0;
+/// One second of audio. Engine is blocked when playback falls this much behind
+static const size_t RHStreamingBufferCapacity = 24000;
+static const std::chrono::milliseconds RHStreamingDrainCheckInterval(50);
+/// Utterances pre-rendered at the same time
+static const size_t RHSpeculativeRenderingLimit = 2;
+/// Cached audio is synthesized at this volume and scaled to utterance volume on playback, so volume changes hit the cache
+static const double RHCachedVolume = 1.0;
+/// Half a second of audio per buffer. Synthesis waits for file writer only when it falls a whole buffer behind
+static const size_t RHFileWriterBufferSize = 12000;
+
+static RHVoice::utterance_priority RHUtterancePriority(RHSpeechUtterancePriority priority) {
+    switch (priority) {
+        case RHSpeechUtterancePriorityBackground:
+            return RHVoice::utterance_priority_background;
+        case RHSpeechUtterancePriorityInterrupt:
+            return RHVoice::utterance_priority_interrupt;
+        default:
+            return RHVoice::utterance_priority_normal;
+    }
+}
+
+static std::unique_ptr<RHVoice::audio_file_sink> RHCreateAudioFileSink(NSString *path, RHSpeechAudioFileFormat format) {
+    switch (format) {
+        case RHSpeechAudioFileFormatFLAC:
+            return std::unique_ptr<RHVoice::audio_file_sink>(new RHExtAudioFileSink(NSStringToSTDString(path), kAudioFileFLACType, kAudioFormatFLAC, RHStreamingSampleRate));
+        case RHSpeechAudioFileFormatOpus:
+            return std::unique_ptr<RHVoice::audio_file_sink>(new RHExtAudioFileSink(NSStringToSTDString(path), kAudioFileCAFType, kAudioFormatOpus, RHStreamingSampleRate));
+        default: {
+            std::unique_ptr<RHVoice::audio_player> player(new RHVoice::audio_player(NSStringToSTDString(path)));
+            player->set_buffer_size(20);
+            player->set_sample_rate(24000);
+            return std::unique_ptr<RHVoice::audio_file_sink>(player.release());
+        }
+    }
+}
+
+@interface RHSpeechSynthesizer() <RHSpeechUtteranceClientPrivateDelegate> {
     BOOL _isSpeaking;
-    dispatch_queue_t underlyingQueue;
+    std::unique_ptr<RHVoice::utterance_scheduler> scheduler;
+    std::unique_ptr<RHVoice::speculative_renderer> speculativeRenderer;
 }
-@property (strong, atomic) AVAudioPlayer *player;
+@property (strong, atomic) AVAudioEngine *audioEngine;
+/// Utterance the scheduler is running now. Only changed on scheduler thread
 @property (strong, atomic) RHSpeechUtterance *currentUtterance;
-@property (strong, atomic) RHSpeechUtteranceClient *currentUtteranceClient;
 
 @end
 
@@ -61,7 +105,9 @@
 - (instancetype)init {
     self = [super init];
     if (self) {
-        underlyingQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0);
+        scheduler.reset(new RHVoice::utterance_scheduler());
+        speculativeRenderer.reset(new RHVoice::speculative_renderer(RHSpeculativeRenderingLimit));
+        self.parallelSynthesisThreadCount = 1;
     }
     
     return self;
@@ -71,19 +117,41 @@
 
 - (void)speak:(RHSpeechUtterance *)utterance {
     
+    [self dropSpeculativeRenderingExceptUtterance:utterance];
+    /// Owned by this task only, so a late cancel hook can not silence the utterance that runs next
+    std::shared_ptr<RHVoice::pcm_ring_buffer> buffer = std::make_shared<RHVoice::pcm_ring_buffer>(RHStreamingBufferCapacity);
     __weak RHSpeechSynthesizer *weakSelf = self;
-    dispatch_async(underlyingQueue, ^{
-        [weakSelf speakInternal:utterance];
+    scheduler->submit(RHUtterancePriority(utterance.priority), [weakSelf, utterance, buffer](const std::atomic<bool>& cancelled) {
+        if(cancelled) {
+            [weakSelf finishCancelledUtterance:utterance];
+            return;
+        }
+        [weakSelf speakInternal:utterance buffer:buffer cancelled:cancelled];
+    }, [buffer]() {
+        buffer->cancel();
     });
 }
 
 - (void)synthesizeUtterance:(RHSpeechUtterance *)utterance
                toFileAtPath:(NSString *)path {
+    [self synthesizeUtterance:utterance toFileAtPath:path format:RHSpeechAudioFileFormatWAV];
+}
+
+- (void)synthesizeUtterance:(RHSpeechUtterance *)utterance
+               toFileAtPath:(NSString *)path
+                     format:(RHSpeechAudioFileFormat)format {
+    [self dropSpeculativeRenderingExceptUtterance:utterance];
     __weak RHSpeechSynthesizer *weakSelf = self;
-    dispatch_async(underlyingQueue, ^{
+    scheduler->submit(RHUtterancePriority(utterance.priority), [weakSelf, utterance, path, format](const std::atomic<bool>& cancelled) {
+        if(cancelled) {
+            [weakSelf finishCancelledUtterance:utterance];
+            return;
+        }
         [weakSelf synthesizeInternalUtterance:utterance
-                                 toFileAtPath:path];
-    });
+                                 toFileAtPath:path
+                                       format:format
+                                    cancelled:cancelled];
+    }, RHVoice::utterance_scheduler::cancel_function());
 }
 
 - (void)synthesizeUtterance:(RHSpeechUtterance *)utterance
@@ -95,10 +163,38 @@
         return;
     }
     
+    [self dropSpeculativeRenderingExceptUtterance:utterance];
     __weak RHSpeechSynthesizer *weakSelf = self;
-    dispatch_async(underlyingQueue, ^{
+    scheduler->submit(RHUtterancePriority(utterance.priority), [weakSelf, utterance, client](const std::atomic<bool>& cancelled) {
+        if(cancelled) {
+            [client cancel];
+            [weakSelf finishCancelledUtterance:utterance];
+            return;
+        }
         [weakSelf synthesizeInternalUtterance:utterance
-                                       client:client];
+                                       client:client
+                                    cancelled:cancelled];
+    }, [client]() {
+        [client cancel];
+    });
+}
+
+- (void)prewarmVoice:(RHSpeechSynthesisVoice *)voice
+          completion:(void (^ _Nullable)(void))completion {
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^{
+        RHSpeechUtterance *utterance = [[RHSpeechUtterance alloc] initWithText:@"1."];
+        utterance.voice = voice;
+        RHVoice::warm_up_player player;
+        try {
+            std::unique_ptr<RHVoice::document> doc = [utterance rhVoiceDocument];
+            doc->set_owner(player);
+            doc->synthesize();
+        } catch(const std::exception& exception) {
+            [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"Failed to prewarm voice %@: %s", voice.name, exception.what()];
+        }
+        if(completion != nil) {
+            completion();
+        }
     });
 }
 
@@ -107,17 +203,45 @@
 }
 
 - (void)stopAndCancel {
-    [self.player stop];
-    [self.currentUtteranceClient cancel];
+    speculativeRenderer->cancel_all();
+    scheduler->cancel_all();
+}
+
+- (void)preSynthesizeUtterance:(RHSpeechUtterance *)utterance {
+    RHUtteranceCache *utteranceCache = self.utteranceCache;
+    if(utteranceCache == nil || utterance.isEmpty || utterance.voice == nil || utterance.textStream != nil) {
+        return;
+    }
     
-    __weak RHSpeechSynthesizer *weakSelf = self;
-    dispatch_async(underlyingQueue, ^{
-        [weakSelf cleanUp];
+    speculativeRenderer->enqueue([utteranceCache cache], [utterance rhVoiceCacheKey], [utterance](RHVoice::client& owner) {
+        pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+        try {
+            std::unique_ptr<RHVoice::document> doc = [utterance rhVoiceDocumentWithVolume:RHCachedVolume];
+            doc->set_owner(owner);
+            doc->synthesize();
+        } catch(const std::exception& exception) {
+            [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"Failed to pre-synthesize utterance('%@'): %s", utterance.ssml, exception.what()];
+            throw;
+        }
     });
 }
 
 #pragma mark - Private
 
+- (void)dropSpeculativeRenderingExceptUtterance:(RHSpeechUtterance *)utterance {
+    if(self.utteranceCache == nil || speculativeRenderer->empty()) {
+        return;
+    }
+    speculativeRenderer->drop_all_except([utterance rhVoiceCacheKey]);
+}
+
+/// Utterance was cancelled before scheduler started it
+- (void)finishCancelledUtterance:(RHSpeechUtterance *)utterance {
+    if([self.delegate respondsToSelector:@selector(speechSynthesizer:didFinish:)]) {
+        [self.delegate speechSynthesizer:self didFinish:utterance];
+    }
+}
+
 - (void)cleanUp {
     if(self.currentUtterance != nil) {
         if([self.delegate respondsToSelector:@selector(speechSynthesizer:didFinish:)]) {
@@ -125,20 +249,24 @@
         }
     }
     self.currentUtterance = nil;
-    self.currentUtteranceClient = nil;
     
-    if (self.player != nil) {
-        [[NSFileManager defaultManager] removeItemAtURL:self.player.url error:nil];
-        self.player = nil;
-        
+    AVAudioEngine *audioEngine = nil;
+    @synchronized (self) {
+        audioEngine = self.audioEngine;
+        self.audioEngine = nil;
+    }
+    
+    if (audioEngine != nil) {
+        [audioEngine stop];
 #if TARGET_OS_IPHONE
         [[AVAudioSession sharedInstance] setActive:NO error:nil];
 #endif
-        [[NSFileManager defaultManager] RHRemoveTempFolderIfNeededPath:[NSString RHTemporaryFolderPath]];
     }
 }
 
-- (void)speakInternal:(RHSpeechUtterance *)utterance {
+- (void)speakInternal:(RHSpeechUtterance *)utterance
+               buffer:(std::shared_ptr<RHVoice::pcm_ring_buffer>)buffer
+            cancelled:(const std::atomic<bool> &)cancelled {
     
     if(utterance.isEmpty) {
         if([self.delegate respondsToSelector:@selector(speechSynthesizer:didFinish:)]) {
@@ -147,57 +275,109 @@
         return;
     }
     
-    _isSpeaking = YES;
-    [[NSFileManager defaultManager] RHCreateTempFolderIfNeededPath:[NSString RHTemporaryFolderPath]];
-    NSString *path = [NSString RHTemporaryPathWithExtesnion:@"wav"];
+    if(utterance.voice == nil) {
+        NSError *error = [NSError errorWithDomain:NSStringFromClass([self class]) code:404 userInfo:nil];
+        CALLDELEGATE_WITH_ERROR_IF_NEEDED_AND_EXIT(error);
+    }
     
-    [self synthesizeInternalUtterance:utterance
-                         toFileAtPath:path];
-
+    _isSpeaking = YES;
     NSError *error = nil;
-    NSURL *url = [NSURL fileURLWithPath:path];
-    self.player = [[AVAudioPlayer alloc] initWithContentsOfURL:url error:&error];
-    CALLDELEGATE_WITH_ERROR_IF_NEEDED_AND_EXIT(error);
-#if TARGET_OS_IPHONE 
+#if TARGET_OS_IPHONE
     [[AVAudioSession sharedInstance] setCategory:AVAudioSessionCategoryPlayback error:&error];
     CALLDELEGATE_WITH_ERROR_IF_NEEDED_AND_EXIT(error);
     [[AVAudioSession sharedInstance] setActive:YES error:&error];
     CALLDELEGATE_WITH_ERROR_IF_NEEDED_AND_EXIT(error);
 #endif
     
+    AVAudioEngine *audioEngine = [self audioEngineForBuffer:buffer];
+    
+    @synchronized (self) {
+        self.audioEngine = audioEngine;
+    }
     self.currentUtterance = utterance;
-    self.player.delegate = self;
-    self.player.volume = 1;
-    self.player.rate = 1;
-    [self.player prepareToPlay];
-    [self.player play];
     
-    while (self.player.isPlaying)
-    {
-        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.3]];
+    __weak RHSpeechSynthesizer *weakSelf = self;
+    NSError *startError = nil;
+    RHVoice::stream_player player(*buffer);
+    player.set_first_chunk_callback([weakSelf, audioEngine, utterance, buffer, &startError]() {
+        NSError *engineError = nil;
+        if(![audioEngine startAndReturnError:&engineError]) {
+            [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"Can not start audio engine. Error:%@", engineError];
+            /// Nothing would ever drain the buffer, so synthesis has to stop instead of blocking on it
+            startError = engineError;
+            buffer->cancel();
+            return;
+        }
+        RHSpeechSynthesizer *strongSelf = weakSelf;
+        if([strongSelf.delegate respondsToSelector:@selector(speechSynthesizer:didStartSpeaking:)]) {
+            [strongSelf.delegate speechSynthesizer:strongSelf didStartSpeaking:utterance];
+        }
+    });
+    
+    try {
+        [self synthesizeCachedUtterance:utterance owner:player cancelled:cancelled];
+    } catch(const std::exception& exception) {
+        NSString *exceptionMessage = @"";
+        if(exception.what() != nil) {
+            exceptionMessage = STDStringToNSString(exception.what());
+        }
+        [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"Exception happened during synthesize utterance('%@'). Exception:%@", utterance.ssml, exceptionMessage];
+    }
+    buffer->finish();
+    
+    while (!buffer->wait_for_drain(RHStreamingDrainCheckInterval) && audioEngine.isRunning) {
+    }
+    if(!buffer->is_cancelled()) {
+        /// Samples handed to the source node are still in the output device buffers
+        [NSThread sleepForTimeInterval:audioEngine.outputNode.presentationLatency];
     }
     
     _isSpeaking = NO;
+    if(startError != nil) {
+        self.currentUtterance = nil;
+        [self callDelegateWithError:startError forUtterance:utterance];
+        return;
+    }
+    [self cleanUp];
+}
+
+- (AVAudioEngine *)audioEngineForBuffer:(std::shared_ptr<RHVoice::pcm_ring_buffer>)buffer {
+    AVAudioFormat *format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:RHStreamingSampleRate
+                                                                           channels:1];
+    AVAudioSourceNode *sourceNode = [[AVAudioSourceNode alloc] initWithFormat:format
+                                                                  renderBlock:^OSStatus(BOOL *isSilence,
+                                                                                        const AudioTimeStamp *timestamp,
+                                                                                        AVAudioFrameCount frameCount,
+                                                                                        AudioBufferList *outputData) {
+        float *frames = static_cast<float *>(outputData->mBuffers[0].mData);
+        const size_t rendered = buffer->read(frames, frameCount);
+        std::fill(frames + rendered, frames + frameCount, 0.0f);
+        *isSilence = rendered == 0;
+        return noErr;
+    }];
+    
+    AVAudioEngine *audioEngine = [[AVAudioEngine alloc] init];
+    [audioEngine attachNode:sourceNode];
+    [audioEngine connect:sourceNode to:audioEngine.mainMixerNode format:format];
+    [audioEngine prepare];
+    return audioEngine;
 }
 
 - (void)synthesizeInternalUtterance:(RHSpeechUtterance *)utterance
-                             client:(RHSpeechUtteranceClient *)client {
+                             client:(RHSpeechUtteranceClient *)client
+                          cancelled:(const std::atomic<bool> &)cancelled {
     if(utterance.voice == nil) {
         NSError *error = [NSError errorWithDomain:NSStringFromClass([self class]) code:404 userInfo:nil];
         CALLDELEGATE_WITH_ERROR_IF_NEEDED_AND_EXIT(error);
     }
     
     self.currentUtterance = utterance;
-    self.currentUtteranceClient = client;
     
     [client setDelegate:self];
     client.utterance = utterance;
     
-    std::unique_ptr<RHVoice::document> doc = [utterance rhVoiceDocument];
-    
-    doc->set_owner(*client.client);
     try {
-        doc->synthesize();
+        [self synthesizeCachedUtterance:utterance owner:*client.client cancelled:cancelled];
     } catch(const std::exception& exception) {
         NSString *exceptionMessage = @"";
         if(exception.what() != nil) {
@@ -211,7 +391,9 @@
 }
 
 - (void)synthesizeInternalUtterance:(RHSpeechUtterance *)utterance
-                       toFileAtPath:(NSString *)path {
+                       toFileAtPath:(NSString *)path
+                             format:(RHSpeechAudioFileFormat)format
+                          cancelled:(const std::atomic<bool> &)cancelled {
     if(utterance.isEmpty) {
         if([self.delegate respondsToSelector:@selector(speechSynthesizer:didFinish:)]) {
             [self.delegate speechSynthesizer:self didFinish:utterance];
@@ -228,15 +410,11 @@
         CALLDELEGATE_WITH_ERROR_IF_NEEDED_AND_EXIT(error);
     }
     
-    RHVoice::audio_player player(NSStringToSTDString(path));
-    player.set_buffer_size(20);
-    player.set_sample_rate(24000);
+    std::unique_ptr<RHVoice::audio_file_sink> sink = RHCreateAudioFileSink(path, format);
+    RHVoice::buffered_file_client writer(*sink, RHFileWriterBufferSize);
     
-    std::unique_ptr<RHVoice::document> doc = [utterance rhVoiceDocument];
-    
-    doc->set_owner(player);
     try {
-        doc->synthesize();
+        [self synthesizeCachedUtterance:utterance owner:writer cancelled:cancelled];
     } catch(const std::exception& exception) {
         NSString *exceptionMessage = @"";
         if(exception.what() != nil) {
@@ -244,14 +422,75 @@
         }
         [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"Exception happened during synthesize utterance('%@'). Exception:%@", utterance.ssml, exceptionMessage];
     }
-    player.finish();
+    if(!writer.finish()) {
+        [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"Failed to write audio file %@", path];
+    }
+    const RHVoice::buffered_file_client::statistics statistics = writer.get_statistics();
+    NSNumber *fileSize = [[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil][NSFileSize];
+    [RHVoiceLogger logAtLevel:RHVoiceLogLevelDebug format:@"Wrote %@ bytes for %llu samples to %@. Encoding took %f s of CPU, synthesis waited for writer %zu times",
+     fileSize, (unsigned long long)statistics.samples, path.lastPathComponent, statistics.encode_seconds, statistics.stalls];
     
-    if(![self isSpeaking]) {
-        if([self.delegate respondsToSelector:@selector(speechSynthesizer:didFinish:)]) {
-            [self.delegate speechSynthesizer:self didFinish:utterance];
+    if([self.delegate respondsToSelector:@selector(speechSynthesizer:didFinish:)]) {
+        [self.delegate speechSynthesizer:self didFinish:utterance];
+    }
+}
+
+/// Engine checks `cancelled` at every audio chunk, word and sentence through `cancellable_client`
+- (void)synthesizeCachedUtterance:(RHSpeechUtterance *)utterance
+                            owner:(RHVoice::client &)owner
+                        cancelled:(const std::atomic<bool> &)cancelled {
+    RHVoice::cancellable_client cancellableClient(owner, cancelled);
+    RHUtteranceCache *utteranceCache = self.utteranceCache;
+    if(utteranceCache == nil || utterance.textStream != nil) {
+        [self synthesizeDocumentForUtterance:utterance volume:utterance.volume owner:cancellableClient cancelled:cancelled];
+        return;
+    }
+    
+    std::shared_ptr<RHVoice::utterance_cache> cache = [utteranceCache cache];
+    const std::string key = [utterance rhVoiceCacheKey];
+    speculativeRenderer->join(key);
+    std::shared_ptr<const RHVoice::recording_client> recording = cache->find(key);
+    if(recording) {
+        RHVoice::gain_client gainClient(cancellableClient, utterance.volume / RHCachedVolume);
+        if(recording->replay(gainClient, 0)) {
+            gainClient.done();
         }
-        self.currentUtterance = nil;
+        return;
     }
+    
+    RHVoice::gain_client gainClient(owner, utterance.volume / RHCachedVolume);
+    RHVoice::caching_client cachingClient(gainClient, *cache, key);
+    RHVoice::cancellable_client cancellableCachingClient(cachingClient, cancelled);
+    [self synthesizeDocumentForUtterance:utterance volume:RHCachedVolume owner:cancellableCachingClient cancelled:cancelled];
+}
+
+- (void)synthesizeDocumentForUtterance:(RHSpeechUtterance *)utterance
+                                volume:(double)volume
+                                 owner:(RHVoice::client &)owner
+                             cancelled:(const std::atomic<bool> &)cancelled {
+    if(utterance.textStream != nil) {
+        std::unique_ptr<RHVoice::incremental_document> doc = [utterance rhVoiceIncrementalDocumentWithCancellation:&cancelled];
+        doc->set_owner(owner);
+        RH_TRACE_SPAN("incremental.synthesize");
+        doc->synthesize();
+        return;
+    }
+    
+    const NSUInteger threadCount = self.parallelSynthesisThreadCount;
+    if(threadCount > 1 && utterance.plainText.length > 0) {
+        std::unique_ptr<RHVoice::parallel_document> doc = [utterance rhVoiceParallelDocumentWithThreadCount:threadCount
+                                                                                                    volume:volume
+                                                                                              cancellation:&cancelled];
+        doc->set_owner(owner);
+        RH_TRACE_SPAN("parallel.synthesize");
+        doc->synthesize();
+        return;
+    }
+    
+    std::unique_ptr<RHVoice::document> doc = [utterance rhVoiceDocumentWithVolume:volume];
+    doc->set_owner(owner);
+    RH_TRACE_SPAN("document.synthesize");
+    doc->synthesize();
 }
 
 - (void)callDelegateWithError:(NSError *)error
@@ -262,16 +501,6 @@
     [self cleanUp];
 }
 
-#pragma mark - AVAudioPlayerDelegate
-
-- (void)audioPlayerDidFinishPlaying:(AVAudioPlayer *)player successfully:(BOOL)flag {
-    [self cleanUp];
-}
-
-- (void)audioPlayerDecodeErrorDidOccur:(AVAudioPlayer *)player error:(NSError * __nullable)error {
-    [self callDelegateWithError:error forUtterance:self.currentUtterance];
-}
-
 #pragma mark - RHSpeechUtteranceClientPrivateDelegate
 - (void)utteranceClientDidStart:(RHSpeechUtteranceClient *_Nonnull)utteranceClient {
     if([self.delegate respondsToSelector:@selector(speechSynthesizer:didBeginSynthesizing:)]) {
@@ -0,0 +1,64 @@
+//
+//  RHSpeechTextStream.mm
+//  RHVoice
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#import "RHSpeechTextStream.h"
+#import "RHSpeechTextStream+Private.h"
+
+#import "NSString+stdStringAddtitons.h"
+
+@interface RHSpeechTextStream () {
+    std::shared_ptr<RHVoice::incremental_text> text;
+}
+@end
+
+@implementation RHSpeechTextStream
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        text = std::make_shared<RHVoice::incremental_text>();
+    }
+    return self;
+}
+
+- (BOOL)isFinished {
+    return text->is_finished();
+}
+
+- (void)appendText:(NSString *)appendedText {
+    const RHUTF8Bytes bytes(appendedText);
+    text->append(bytes.data(), bytes.size());
+}
+
+- (void)finish {
+    text->finish();
+}
+
+#pragma mark - Private
+
+- (std::shared_ptr<RHVoice::incremental_text>)rhVoiceText {
+    return text;
+}
+
+@end
@@ -30,26 +30,56 @@
 #import "RHVoiceBridge+PrivateAdditions.h"
 #include "RHSpeechUtterance+Private.h"
 #include "RHSpeechSynthesisVoice+Private.h"
+#include "RHSpeechTextStream+Private.h"
 
 #import "NSString+stdStringAddtitons.h"
 
-@interface RHSpeechUtterance()
+#include "RHTrace.h"
+
+static NSString * const RHSpeakElementOpening = @"<speak>";
+static NSString * const RHSpeakElementClosing = @"</speak>";
+
+namespace {
+    /// Keeps text alive for as long as its offset index is used
+    struct RHMarkerMapping {
+        explicit RHMarkerMapping(const std::shared_ptr<const RHUTF8Bytes> &text):
+            text(text),
+            index(text->data(), text->size()) {}
+        
+        const std::shared_ptr<const RHUTF8Bytes> text;
+        const RHVoice::utf16_offset_index index;
+    };
+}
+
+@interface RHSpeechUtterance() {
+    std::shared_ptr<const RHUTF8Bytes> utf8Text;
+    std::shared_ptr<const RHVoice::utf16_offset_index> offsetIndex;
+}
+@property (nonatomic, strong, nullable) NSString *plainText;
 @end
 
 @implementation RHSpeechUtterance
 
+@synthesize ssml = _ssml;
+
 - (instancetype)init {
     return [self initWithText:nil];
 }
 
 - (instancetype)initWithText:(NSString * _Nullable)text {
-    
-    NSString *textInternal = text;
-    if(textInternal == nil) {
-        textInternal = @"";
+    self = [self initWithSSML:nil];
+    if(self) {
+        self.plainText = text ?: @"";
     }
-    
-    return [self initWithSSML:[NSString stringWithFormat:@"<speak>%@</speak>", textInternal]];;
+    return self;
+}
+
+- (instancetype)initWithTextStream:(RHSpeechTextStream *)textStream {
+    self = [self initWithSSML:nil];
+    if(self) {
+        _textStream = textStream;
+    }
+    return self;
 }
 
 - (instancetype)initWithSSML:(NSString * _Nullable)ssml {
@@ -59,12 +89,26 @@
         self.rate = 1.0;
         self.volume = 1.0;
         self.quality = RHSpeechUtteranceQualityStandart;
+        self.priority = RHSpeechUtterancePriorityNormal;
         self.voice = [[RHSpeechSynthesisVoice speechVoices] firstObject];
     }
     return self;
 }
 
+- (NSString *)ssml {
+    if(self.plainText != nil) {
+        return [NSString stringWithFormat:@"%@%@%@", RHSpeakElementOpening, self.plainText, RHSpeakElementClosing];
+    }
+    return _ssml;
+}
+
 - (BOOL)isEmpty {
+    if(self.textStream != nil) {
+        return NO;
+    }
+    if(self.plainText != nil) {
+        return self.plainText.length == 0;
+    }
     return self.ssml.length == 0 || self.ssml == nil || [self.ssml isEqualToString:@"<speak></speak>"];
 }
 
@@ -83,20 +127,117 @@
     }
 }
 
+/// Text as engine gets it. Converted to UTF-8 at most once per utterance
+- (std::shared_ptr<const RHUTF8Bytes>)rhVoiceText {
+    @synchronized (self) {
+        if(!utf8Text) {
+            utf8Text = std::make_shared<const RHUTF8Bytes>(self.plainText ?: _ssml);
+        }
+        return utf8Text;
+    }
+}
+
 - (std::unique_ptr<RHVoice::document>)rhVoiceDocument {
+    return [self rhVoiceDocumentWithVolume:self.volume];
+}
+
+- (std::unique_ptr<RHVoice::document>)rhVoiceDocumentWithVolume:(double)volume {
     std::unique_ptr<RHVoice::document> doc;
-    RHVoice::voice_profile voiceProfile = [RHVoiceBridge sharedInstance].engine->create_voice_profile(NSStringToSTDString(self.voiceProfile ?: self.voice.name));
+    /// Profile and document have to come from the same engine even if it is recreated meanwhile
+    std::shared_ptr<RHVoice::engine> engine = [RHVoiceBridge sharedInstance].engine;
+    RHVoice::voice_profile voiceProfile = engine->create_voice_profile(NSStringToSTDString(self.voiceProfile ?: self.voice.name));
     
     /// Using wsting or any other utf16 string is causing huge memory usage that is much bigger than 60 MB that is a limit for app extention
-    std::string textToSpeak = NSStringToSTDString(self.ssml);
-    doc = RHVoice::document::create_from_ssml([RHVoiceBridge sharedInstance].engine,
-                                     textToSpeak.cbegin(),
-                                     textToSpeak.cend(),
-                                     voiceProfile);
+    std::shared_ptr<const RHUTF8Bytes> text = [self rhVoiceText];
+    const char *textBegin = text->data();
+    const char *textEnd = text->data() + text->size();
+    RH_TRACE_SPAN("document.create");
+    if(self.plainText != nil) {
+        doc = RHVoice::document::create_from_plain_text(engine,
+                                                       textBegin,
+                                                       textEnd,
+                                                       RHVoice::content_text,
+                                                       voiceProfile);
+    } else {
+        doc = RHVoice::document::create_from_ssml(engine,
+                                                 textBegin,
+                                                 textEnd,
+                                                 voiceProfile);
+    }
     doc->speech_settings.relative.rate = self.rate;
-    doc->speech_settings.relative.volume = self.volume;
+    doc->speech_settings.relative.volume = volume;
     doc->quality.set_from_string(self.rhVoiceQuality);
     
     return doc;
 }
+
+- (std::shared_ptr<const RHVoice::utf16_offset_index>)rhVoiceOffsetIndex {
+    if(self.textStream != nil) {
+        /// Text is not known in advance
+        return nullptr;
+    }
+    std::shared_ptr<const RHUTF8Bytes> text = [self rhVoiceText];
+    @synchronized (self) {
+        if(!offsetIndex) {
+            std::shared_ptr<const RHMarkerMapping> mapping = std::make_shared<const RHMarkerMapping>(text);
+            offsetIndex = std::shared_ptr<const RHVoice::utf16_offset_index>(mapping, &mapping->index);
+        }
+        return offsetIndex;
+    }
+}
+
+- (NSUInteger)rhVoiceMarkerLocationOffset {
+    /// Plain text goes right after opening element in `ssml`
+    return self.plainText != nil ? RHSpeakElementOpening.length : 0;
+}
+
+- (std::string)rhVoiceCacheKey {
+    std::shared_ptr<const RHUTF8Bytes> text = [self rhVoiceText];
+    /// Trailing whitespace does not change audio or positions of markers before it
+    std::size_t size = text->size();
+    while(size > 0 && isspace(static_cast<unsigned char>(text->data()[size - 1]))) {
+        --size;
+    }
+    
+    /// Voice data, config or dictionaries could change when engine is recreated
+    NSString *key = [NSString stringWithFormat:@"%lu|%@|%.17g|%@|",
+                     (unsigned long)[RHVoiceBridge sharedInstance].engineGeneration,
+                     self.voiceProfile ?: self.voice.name,
+                     self.rate,
+                     self.plainText != nil ? @"text" : @"ssml"];
+    return NSStringToSTDString(key) + self.rhVoiceQuality + "|" + std::string(text->data(), size);
+}
+
+- (std::unique_ptr<RHVoice::parallel_document>)rhVoiceParallelDocumentWithThreadCount:(NSUInteger)threadCount
+                                                                                volume:(double)volume
+                                                                          cancellation:(const std::atomic<bool> *)cancellation {
+    RHVoice::parallel_document_settings settings;
+    std::shared_ptr<RHVoice::engine> engine = [RHVoiceBridge sharedInstance].engine;
+    settings.profile = engine->create_voice_profile(NSStringToSTDString(self.voiceProfile ?: self.voice.name));
+    settings.rate = self.rate;
+    settings.volume = volume;
+    settings.quality = self.rhVoiceQuality;
+    settings.thread_count = threadCount;
+    settings.cancellation = cancellation;
+    
+    std::shared_ptr<const RHUTF8Bytes> text = [self rhVoiceText];
+    return std::unique_ptr<RHVoice::parallel_document>(new RHVoice::parallel_document(engine,
+                                                                                      text->data(),
+                                                                                      text->size(),
+                                                                                      settings));
+}
+
+- (std::unique_ptr<RHVoice::incremental_document>)rhVoiceIncrementalDocumentWithCancellation:(const std::atomic<bool> *)cancellation {
+    RHVoice::incremental_document_settings settings;
+    std::shared_ptr<RHVoice::engine> engine = [RHVoiceBridge sharedInstance].engine;
+    settings.profile = engine->create_voice_profile(NSStringToSTDString(self.voiceProfile ?: self.voice.name));
+    settings.rate = self.rate;
+    settings.volume = self.volume;
+    settings.quality = self.rhVoiceQuality;
+    settings.cancellation = cancellation;
+    
+    return std::unique_ptr<RHVoice::incremental_document>(new RHVoice::incremental_document(engine,
+                                                                                            [self.textStream rhVoiceText],
+                                                                                            settings));
+}
 @end
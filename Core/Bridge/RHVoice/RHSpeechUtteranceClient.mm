@@ -12,9 +12,10 @@
 #import "RHSpeechSynthesisMarker.h"
 #import "RHSpeechSynthesisMarker+Private.h"
 
-#import "NSString+Additions.h"
 #import "RHSpeechUtterance.h"
+#include "RHSpeechUtterance+Private.h"
 #import "NSString+stdStringAddtitons.h"
+#import "RHAudioRingBuffer+Private.h"
 
 #include <memory>
 #include <stdexcept>
@@ -22,8 +23,6 @@
 #include <fstream>
 #include <iterator>
 #include <algorithm>
-#include <queue>
-#include <vector>
 
 #include "core/engine.hpp"
 #include "core/document.hpp"
@@ -35,7 +34,7 @@ namespace RHVoice
 class RHSpeechClient: public client
 {
 public:
-    explicit RHSpeechClient(RHSpeechUtteranceClient *delegate);
+    RHSpeechClient(RHSpeechUtteranceClient *delegate, const std::shared_ptr<pcm_ring_buffer>& buffer);
     bool play_speech(const short* samples,std::size_t count) override;
     event_mask get_supported_events() const override;
     bool word_starts(std::size_t position,std::size_t length) override;
@@ -45,6 +44,7 @@ public:
     
 private:
     RHSpeechUtteranceClient * _delegate;
+    std::shared_ptr<pcm_ring_buffer> _buffer;
 };
 }
 
@@ -57,17 +57,17 @@ private:
     dispatch_queue_t markersQueue;
     RHSpeechSynthesisMarker *lastWordMarker;
     RHSpeechSynthesisMarker *lastSentenceMarker;
-    NSInteger lastWordBeginUTF8Index;
-    NSInteger lastWordBeginUTF16Index;
-    NSInteger lastSentenceBeginUTF8Index;
-    NSInteger lastSentenceBeginUTF16Index;
+    std::shared_ptr<const RHVoice::utf16_offset_index> offsetIndex;
+    NSUInteger markerLocationOffset;
 }
 @property(atomic, assign) RHSpeechUtteranceClientStatus status;
 @property(nonatomic, assign) int bufferSize;
-- (BOOL)speechClientSynthesized:(std::vector<short> &)levels __attribute__((objc_direct));
+- (BOOL)speechClientWillSynthesize __attribute__((objc_direct));
+- (BOOL)speechClientSynthesized:(const short *)samples count:(std::size_t)count __attribute__((objc_direct));
 - (void)speechClientFinished __attribute__((objc_direct));
 - (BOOL)didStartWordWithRange:(NSRange)range __attribute__((objc_direct));
 - (BOOL)didStartSentenceWithRange:(NSRange)range __attribute__((objc_direct));
+- (NSRange)utf16RangeFromUTF8:(NSRange)range __attribute__((objc_direct));
 - (int)audioBufferSize __attribute__((objc_direct));
 @end
 
@@ -81,11 +81,17 @@ namespace RHVoice
                event_sentence_starts;
     }
     
-    RHSpeechClient::RHSpeechClient(RHSpeechUtteranceClient *delegate):_delegate(delegate) {}
+    RHSpeechClient::RHSpeechClient(RHSpeechUtteranceClient *delegate, const std::shared_ptr<pcm_ring_buffer>& buffer):_delegate(delegate), _buffer(buffer) {}
     
     bool RHSpeechClient::play_speech(const short* samples, std::size_t count) {
-        std::vector<short> levels(samples, samples + count);
-        return [_delegate speechClientSynthesized:levels];
+        if(!_buffer) {
+            return [_delegate speechClientSynthesized:samples count:count];
+        }
+        
+        if(![_delegate speechClientWillSynthesize]) {
+            return false;
+        }
+        return _buffer->write(samples, count) && [_delegate speechClientSynthesized:samples count:count];
     }
 
     bool RHSpeechClient::word_starts(std::size_t position, std::size_t length) {
@@ -101,6 +107,9 @@ namespace RHVoice
     }
 
     void RHSpeechClient::done() {
+        if(_buffer) {
+            _buffer->finish();
+        }
         [_delegate speechClientFinished];
         _delegate = nil;
     }
@@ -109,15 +118,22 @@ namespace RHVoice
 @implementation RHSpeechUtteranceClient
 
 - (instancetype)initWithAudioBufferSize:(int)audioBufferSize {
+    return [self initWithAudioBufferSize:audioBufferSize
+                 audioRingBufferCapacity:0];
+}
+
+- (instancetype)initWithAudioBufferSize:(int)audioBufferSize
+                audioRingBufferCapacity:(NSInteger)audioRingBufferCapacity {
     self = [super init];
     if (self) {
-        client = std::make_shared<RHVoice::RHSpeechClient>(self);
+        std::shared_ptr<RHVoice::pcm_ring_buffer> buffer;
+        if(audioRingBufferCapacity > 0) {
+            _audioRingBuffer = [[RHAudioRingBuffer alloc] initWithCapacity:audioRingBufferCapacity];
+            buffer = [_audioRingBuffer buffer];
+        }
+        client = std::make_shared<RHVoice::RHSpeechClient>(self, buffer);
         self.status = RHSpeechUtteranceClientStatusCreated;
         lastSentenceMarker = lastWordMarker = nil;
-        lastWordBeginUTF8Index = 0;
-        lastWordBeginUTF16Index = 0;
-        lastSentenceBeginUTF8Index = 0;
-        lastSentenceBeginUTF16Index = 0;
         self.bufferSize = audioBufferSize;
         
         
@@ -140,6 +156,14 @@ namespace RHVoice
 
 - (void)cancel {
     self.status = RHSpeechUtteranceClientStatusCanceled;
+    [self.audioRingBuffer cancel];
+}
+
+- (NSInteger)waitForFrames:(NSInteger)frameCount timeout:(NSTimeInterval)timeout {
+    if(self.audioRingBuffer == nil) {
+        return 0;
+    }
+    return [self.audioRingBuffer waitForFrames:frameCount timeout:timeout];
 }
 
 #pragma mark - Privates
@@ -154,6 +178,8 @@ namespace RHVoice
 
 - (void)setUtterance:(RHSpeechUtterance *)utterance {
     _utterance = utterance;
+    offsetIndex = [utterance rhVoiceOffsetIndex];
+    markerLocationOffset = [utterance rhVoiceMarkerLocationOffset];
 }
 
 - (RHSpeechUtterance *)utterance {
@@ -166,18 +192,22 @@ namespace RHVoice
     return self.bufferSize;
 }
 
-- (BOOL)speechClientSynthesized:(std::vector<short> &)levels __attribute__((objc_direct)); {
+- (BOOL)speechClientWillSynthesize __attribute__((objc_direct)); {
     if (self.status == RHSpeechUtteranceClientStatusCreated) {
         self.status = RHSpeechUtteranceClientStatusRendering;
         possition = 0;
         [privateDeleage utteranceClientDidStart:self];
     }
     
-    if(self.status == RHSpeechUtteranceClientStatusCanceled) {
+    return self.status != RHSpeechUtteranceClientStatusCanceled;
+}
+
+- (BOOL)speechClientSynthesized:(const short *)samples count:(std::size_t)count __attribute__((objc_direct)); {
+    if(![self speechClientWillSynthesize]) {
         return NO;
     }
     
-    size_t levelsSize = levels.size();
+    size_t levelsSize = count;
     __typeof(self) __weak weakSelf = self;
     dispatch_async(markersQueue, ^{
         __typeof(self) __strong strongSelf = weakSelf;
@@ -204,7 +234,10 @@ namespace RHVoice
         strongSelf->possition += levelsSize;
     });
     
-    [self.markerDelegate utteranceClientDidReceiveSamples:levels.data() withSize:levels.size()];
+    if(self.audioRingBuffer == nil &&
+       [self.markerDelegate respondsToSelector:@selector(utteranceClientDidReceiveSamples:withSize:)]) {
+        [self.markerDelegate utteranceClientDidReceiveSamples:samples withSize:count];
+    }
     
     return YES;
 }
@@ -216,34 +249,35 @@ namespace RHVoice
     }
 }
 
+- (NSRange)utf16RangeFromUTF8:(NSRange)range __attribute__((objc_direct)); {
+    std::size_t location = 0;
+    std::size_t length = 0;
+    if(!offsetIndex || !offsetIndex->utf16_range(range.location, range.length, location, length)) {
+        return NSMakeRange(NSNotFound, 0);
+    }
+    return NSMakeRange(location + markerLocationOffset, length);
+}
+
 - (BOOL)didStartWordWithRange:(NSRange)range __attribute__((objc_direct)); {
     __typeof(self) __weak weakSelf = self;
     dispatch_async(markersQueue, ^{
         __typeof(self) __strong strongSelf = weakSelf;
-        NSRange utf16range = [strongSelf.utterance.ssml RHutf16RangeFromUTF8:range
-                                                              utf8StartIndex:lastWordBeginUTF8Index
-                                                             utf16StartIndex:lastWordBeginUTF16Index];
-        strongSelf->lastWordBeginUTF8Index = range.location;
-        strongSelf->lastWordBeginUTF16Index = utf16range.location;
+        NSRange utf16range = [strongSelf utf16RangeFromUTF8:range];
         strongSelf->lastWordMarker = [[RHSpeechSynthesisMarker alloc] initWithMark:RHSpeechSynthesisMarkerMarkWord 
                                                                          textRange:utf16range];
     });
-    return YES;
+    return self.status != RHSpeechUtteranceClientStatusCanceled;
 }
 
 - (BOOL)didStartSentenceWithRange:(NSRange)range __attribute__((objc_direct)); {
     __typeof(self) __weak weakSelf = self;
     dispatch_async(markersQueue, ^{
         __typeof(self) __strong strongSelf = weakSelf;
-        NSRange utf16range = [strongSelf.utterance.ssml RHutf16RangeFromUTF8:range
-                                                        utf8StartIndex:lastSentenceBeginUTF8Index
-                                                       utf16StartIndex:lastSentenceBeginUTF16Index];
-        strongSelf->lastSentenceBeginUTF8Index = range.location;
-        strongSelf->lastSentenceBeginUTF16Index = utf16range.location;
+        NSRange utf16range = [strongSelf utf16RangeFromUTF8:range];
         strongSelf->lastWordMarker = [[RHSpeechSynthesisMarker alloc] initWithMark:RHSpeechSynthesisMarkerMarkSentence 
                                                                          textRange:utf16range];
     });
-    return YES;
+    return self.status != RHSpeechUtteranceClientStatusCanceled;
 }
 
 @end
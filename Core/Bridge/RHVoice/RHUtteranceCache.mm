@@ -0,0 +1,101 @@
+//
+//  RHUtteranceCache.mm
+//  RHVoice
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+
+#import "RHUtteranceCache.h"
+#import "RHUtteranceCache+Private.h"
+
+#import "NSFileManager+Additions.h"
+#import "NSString+Additions.h"
+#import "NSString+stdStringAddtitons.h"
+
+@interface RHUtteranceCache () {
+    std::shared_ptr<RHVoice::utterance_cache> cache;
+}
+@end
+
+@implementation RHUtteranceCache
+
+- (instancetype)initWithMemoryCapacity:(NSUInteger)memoryCapacity {
+    return [self initWithMemoryCapacity:memoryCapacity
+                           diskCapacity:0];
+}
+
+- (instancetype)initWithMemoryCapacity:(NSUInteger)memoryCapacity
+                          diskCapacity:(NSUInteger)diskCapacity {
+    self = [super init];
+    if (self) {
+        NSString *diskPath = @"";
+        if(diskCapacity > 0) {
+            NSFileManager *fileManager = [NSFileManager defaultManager];
+            [fileManager RHCreateTempFolderIfNeededPath:[NSString RHTemporaryFolderPath]];
+            diskPath = [[NSString RHTemporaryFolderPath] stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+            [fileManager RHCreateTempFolderIfNeededPath:diskPath];
+        }
+        cache = std::make_shared<RHVoice::utterance_cache>(memoryCapacity, NSStringToSTDString(diskPath), diskCapacity);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    cache->clear();
+}
+
+- (NSUInteger)hitCount {
+    return cache->get_statistics().hits;
+}
+
+- (NSUInteger)diskHitCount {
+    return cache->get_statistics().disk_hits;
+}
+
+- (NSUInteger)missCount {
+    return cache->get_statistics().misses;
+}
+
+- (NSUInteger)memoryBytes {
+    return cache->get_statistics().memory_bytes;
+}
+
+- (NSUInteger)diskBytes {
+    return cache->get_statistics().disk_bytes;
+}
+
+- (NSUInteger)entryCount {
+    return cache->get_statistics().entry_count;
+}
+
+- (void)removeAllEntries {
+    cache->clear();
+}
+
+@end
+
+@implementation RHUtteranceCache (Private)
+
+- (std::shared_ptr<RHVoice::utterance_cache>)cache {
+    return cache;
+}
+
+@end
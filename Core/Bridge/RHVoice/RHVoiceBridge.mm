@@ -44,9 +44,22 @@
 #include "core/engine.hpp"
 #include "core/package_client.hpp"
 #include "RHVoice.h"
+#include "RHTrace.h"
+
+#include <atomic>
+#include <fstream>
+#include <memory>
 
 @interface RHVoiceBridge () {
+    /// Read with `std::atomic_load` from any thread, replaced with `std::atomic_store` under `@synchronized`
     std::shared_ptr<RHVoice::engine> RHEngine;
+    /// What the engine was created from. `params` can be replaced or changed in place meanwhile
+    NSString *RHEngineDataFingerprint;
+    __weak id<RHVoiceLoggerProtocol> RHEngineLogger;
+    RHVoiceLogLevel RHEngineMinimumLogLevel;
+    /// Engine keeps it for its whole life, kept here to change its level
+    std::shared_ptr<RHEventLoggerImpl> RHEngineEventLogger;
+    std::atomic<NSUInteger> RHEngineGeneration;
 }
 @end
 
@@ -93,15 +106,25 @@
 #pragma mark - Internal
 
 - (std::shared_ptr<RHVoice::engine>)engine {
+    /// Synthesis threads only take a reference to the current engine and do not wait for `recreateEngineIfDataChanged`
+    std::shared_ptr<RHVoice::engine> engine = std::atomic_load(&RHEngine);
+    if(engine.get() != nil) {
+        return engine;
+    }
+    
     @synchronized (self) {
-        if(RHEngine.get() == nil) {
+        if(std::atomic_load(&RHEngine).get() == nil) {
             [self createRHEngineWithParams:self.params];
         }
         
-        return RHEngine;
+        return std::atomic_load(&RHEngine);
     }
 }
 
+- (NSUInteger)engineGeneration {
+    return RHEngineGeneration.load();
+}
+
 - (NSString *)packagesJSON {
     RHVoice::pkg::package_client::ptr packageClient;
     if([self engine].get()) {
@@ -124,11 +147,50 @@
 
 - (void)recreateEngine {
     @synchronized (self) {
-        RHEngine.reset();
+        /// Utterances being synthesized keep the old engine until they finish
+        std::atomic_store(&RHEngine, std::shared_ptr<RHVoice::engine>());
         [self engine];
     }
 }
 
+- (BOOL)recreateEngineIfDataChanged {
+    @synchronized (self) {
+        if(std::atomic_load(&RHEngine).get() != nil && [self isEngineCreatedWithParams:self.params]) {
+            return NO;
+        }
+        [self recreateEngine];
+        return YES;
+    }
+}
+
+- (void)setMinimumLogLevel:(RHVoiceLogLevel)level {
+    @synchronized (self) {
+        self.params.minimumLogLevel = level;
+        RHEngineMinimumLogLevel = level;
+        if(RHEngineEventLogger.get() != nullptr) {
+            RHEngineEventLogger->set_min_level([RHVoiceBridgeParams internalLogLevel:level]);
+        }
+    }
+}
+
+- (void)setTracingEnabled:(BOOL)enabled {
+    RHVoice::trace::set_enabled(enabled);
+}
+
+- (BOOL)writeTraceToPath:(NSString *)path {
+    @synchronized (self) {
+        const bool enabled = RHVoice::trace::is_enabled();
+        RHVoice::trace::set_enabled(false);
+        std::ofstream stream(NSStringToSTDString(path).c_str());
+        RHVoice::trace::write_chrome_trace(stream);
+        stream.close();
+        const BOOL written = !stream.fail();
+        RHVoice::trace::clear();
+        RHVoice::trace::set_enabled(enabled);
+        return written;
+    }
+}
+
 #pragma mark - Private
 
 + (void)load {
@@ -149,15 +211,39 @@
         param.data_path = NSStringToSTDString(params.dataPath);
         param.config_path = NSStringToSTDString(params.configPath);
         param.pkg_path = NSStringToSTDString(params.pkgPath);
-        param.logger = params.rhLogger;
+        std::shared_ptr<RHEventLoggerImpl> logger = params.rhLogger;
+        param.logger = logger;
         
-        RHEngine = RHVoice::engine::create(param);
+        RHEngineDataFingerprint = [self dataFingerprintWithParams:params];
+        RHEngineLogger = params.logger;
+        RHEngineMinimumLogLevel = params.minimumLogLevel;
+        RHEngineEventLogger = logger;
+        std::atomic_store(&RHEngine, RHVoice::engine::create(param));
+        ++RHEngineGeneration;
     } catch (...) {
         [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"No Languages folder is located at: %@", params.dataPath];
         [RHVoiceLogger logAtLevel:RHVoiceLogLevelError format:@"Please set  valid 'dataPath' property. This folder has to contain 'languages' and 'voices' folders."];
     }
 }
 
+- (BOOL)isEngineCreatedWithParams:(RHVoiceBridgeParams *)params {
+    return RHEngineLogger == params.logger &&
+           RHEngineMinimumLogLevel == params.minimumLogLevel &&
+           [RHEngineDataFingerprint isEqualToString:[self dataFingerprintWithParams:params]];
+}
+
+/// Engine reads language and voice packages from data and package folders and its settings from RHVoice.conf
+- (NSString *)dataFingerprintWithParams:(RHVoiceBridgeParams *)params {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSMutableArray<NSString *> *parts = [[NSMutableArray alloc] init];
+    for (NSString *root in @[params.dataPath, params.pkgPath]) {
+        [parts addObject:[fileManager RHPackagesFingerprintAtPath:[root stringByAppendingPathComponent:@"languages"]]];
+        [parts addObject:[fileManager RHPackagesFingerprintAtPath:[root stringByAppendingPathComponent:@"voices"]]];
+    }
+    [parts addObject:[fileManager RHFileFingerprintAtPath:[params.configPath stringByAppendingPathComponent:@"RHVoice.conf"]]];
+    return [parts componentsJoinedByString:@"|"];
+}
+
 - (const RHVoice::voice_list &)voices {
     return [self engine]->get_voices();
 }
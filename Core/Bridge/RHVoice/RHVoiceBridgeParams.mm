@@ -43,6 +43,7 @@
     result.dataPath = pathToData;
     result.configPath = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) firstObject];
     result.pkgPath = result.configPath;
+    result.minimumLogLevel = RHVoiceLogLevelTrace;
     return result;
 }
 
@@ -53,18 +54,35 @@
     }
     
     return [anotherObject.dataPath isEqualToString:self.dataPath] &&
-           [anotherObject.logger isEqual:self.logger];
+           [anotherObject.logger isEqual:self.logger] &&
+           anotherObject.minimumLogLevel == self.minimumLogLevel;
 }
 
 - (NSUInteger)hash {
     return [self.dataPath hash] ^ [self.logger hash];
 }
 
-- (std::shared_ptr<RHVoice::event_logger>)rhLogger
+- (std::shared_ptr<RHEventLoggerImpl>)rhLogger
 {
     if(self.logger != nil && [self.logger respondsToSelector:@selector(logAtLevel:message:)]) {
-        return std::make_shared<RHEventLoggerImpl>();
+        return std::make_shared<RHEventLoggerImpl>([RHVoiceBridgeParams internalLogLevel:self.minimumLogLevel]);
     }
     return nullptr;
 }
+
++ (RHVoice_log_level)internalLogLevel:(RHVoiceLogLevel)level {
+    switch (level) {
+        case RHVoiceLogLevelTrace:
+            return RHVoice_log_level_trace;
+        case RHVoiceLogLevelDebug:
+            return RHVoice_log_level_debug;
+        case RHVoiceLogLevelInfo:
+            return RHVoice_log_level_info;
+        case RHVoiceLogLevelWarning:
+            return RHVoice_log_level_warning;
+        case RHVoiceLogLevelError:
+            return RHVoice_log_level_error;
+    }
+    return RHVoice_log_level_trace;
+}
 @end
@@ -32,6 +32,12 @@ NS_ASSUME_NONNULL_BEGIN
 @interface NSFileManager (Additions)
 - (void)RHCreateTempFolderIfNeededPath:(NSString *)path;
 - (void)RHRemoveTempFolderIfNeededPath:(NSString *)path;
+/// String that changes when a package folder directly under `path` is added, removed or replaced, or when files
+/// are added to or removed from it. Only `path` and its direct children are read, so it is cheap enough to call
+/// before every engine lookup.
+- (NSString *)RHPackagesFingerprintAtPath:(NSString *)path;
+/// Path, size and modification date of one file, or only the path if there is no such file
+- (NSString *)RHFileFingerprintAtPath:(NSString *)path;
 @end
 
 NS_ASSUME_NONNULL_END
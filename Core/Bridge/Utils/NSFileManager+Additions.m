@@ -44,4 +44,35 @@
         }
     }
 }
+
+- (NSString *)RHPackagesFingerprintAtPath:(NSString *)path {
+    NSMutableString *result = [[NSMutableString alloc] initWithString:[self RHFileFingerprintAtPath:path]];
+    NSArray<NSURL *> *packages = [self contentsOfDirectoryAtURL:[NSURL fileURLWithPath:path]
+                                     includingPropertiesForKeys:@[NSURLContentModificationDateKey]
+                                                        options:0
+                                                          error:nil];
+    NSMutableArray<NSString *> *entries = [[NSMutableArray alloc] init];
+    for (NSURL *url in packages) {
+        NSDate *modificationDate = nil;
+        [url getResourceValue:&modificationDate forKey:NSURLContentModificationDateKey error:nil];
+        [entries addObject:[NSString stringWithFormat:@"|%@:%f", url.lastPathComponent, modificationDate.timeIntervalSinceReferenceDate]];
+    }
+    /// Directory listing order is not specified
+    [entries sortUsingSelector:@selector(compare:)];
+    for (NSString *entry in entries) {
+        [result appendString:entry];
+    }
+    return [result copy];
+}
+
+- (NSString *)RHFileFingerprintAtPath:(NSString *)path {
+    NSDictionary<NSFileAttributeKey, id> *attributes = [self attributesOfItemAtPath:path error:nil];
+    if(attributes == nil) {
+        return path;
+    }
+    return [NSString stringWithFormat:@"%@:%llu:%f",
+            path,
+            attributes.fileSize,
+            attributes.fileModificationDate.timeIntervalSinceReferenceDate];
+}
 @end
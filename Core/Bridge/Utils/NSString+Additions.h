@@ -32,10 +32,6 @@ NS_ASSUME_NONNULL_BEGIN
 @interface NSString (Additions)
 + (NSString *)RHTemporaryFolderPath;
 + (NSString *)RHTemporaryPathWithExtesnion:(NSString *)extesnion;
-- (NSRange)RHutf16RangeFromUTF8:(NSRange)range;
-- (NSRange)RHutf16RangeFromUTF8:(NSRange)range
-                 utf8StartIndex:(NSInteger)utf8Index
-                 utf16StartIndex:(NSInteger)utf16Index;
 - (NSDictionary<NSString *, NSString *> * __nullable)RHFileAtPathToDictionary;
 @end
 
@@ -33,67 +33,6 @@
 
 @implementation NSString (Additions)
 
-- (size_t)RHutf8Size {
-    std::string string = NSStringToSTDString(self);
-    return string.size();
-}
-
-- (NSRange)RHutf16RangeFromUTF8:(NSRange)range
-                 utf8StartIndex:(NSInteger)utf8Index
-                utf16StartIndex:(NSInteger)utf16Index
-{
-    NSRange rangeToEnumerate = NSMakeRange(utf16Index, [self length] - utf16Index);
-    if (![self RHisValidRange:rangeToEnumerate]) {
-        return NSMakeRange(NSNotFound, 0);
-    }
-    
-    __block NSUInteger location = NSNotFound;
-    __block NSUInteger length = 0;    
-    __block NSInteger index = utf8Index;
-    __block NSInteger size = 0;
-
-    [self enumerateSubstringsInRange:rangeToEnumerate
-                             options:NSStringEnumerationByComposedCharacterSequences
-                          usingBlock:^(NSString * _Nullable nsChar, NSRange substringRange, NSRange enclosingRange, BOOL * _Nonnull stop) {
-
-        const size_t sizeOfCharacter = nsChar.RHutf8Size;
-        index += sizeOfCharacter;
-        const BOOL isLocationFound = location != NSNotFound;
-
-        if(isLocationFound) {
-            size += sizeOfCharacter;
-        }
-
-        if(index == range.location) {
-            location = substringRange.location + 1;
-            size = 0;
-        }
-
-        if(isLocationFound && size == range.length) {
-            length = substringRange.location - location + 1;
-            *stop = YES;
-        }
-    }];
-    
-    if(length == 0) {
-        return NSMakeRange(NSNotFound, 0);
-    }
-    
-    return NSMakeRange(location, length);
-}
-
-- (BOOL)RHisValidRange:(NSRange)range {
-    const BOOL isLocationValid = range.location <= self.length;
-    const BOOL isEndValid = (range.location + range.length) <= self.length;
-    return isLocationValid && isEndValid;
-}
-
-- (NSRange)RHutf16RangeFromUTF8:(NSRange)range {
-    return [self RHutf16RangeFromUTF8:range
-                       utf8StartIndex:0
-                      utf16StartIndex:0];
-}
-
 - (NSDictionary<NSString *, NSString *> * __nullable)RHFileAtPathToDictionary {
     NSError *error = nil;
     NSString *stringInfo = [NSString stringWithContentsOfFile:self encoding:NSUTF8StringEncoding error: &error];
@@ -28,9 +28,30 @@
 #ifndef NSString_stdStringAddtitons_h
 #define NSString_stdStringAddtitons_h
 
+#include <cstddef>
+#include <memory>
 #include <string>
 
-NSString * _Nullable STDStringToNSString(std::string stdString);
+NSString * _Nullable STDStringToNSString(const std::string &stdString);
 std::string NSStringToSTDString(NSString * _Nullable nsString);
 
+/// UTF-8 bytes of NSString without an intermediate std::string.
+/// Points straight into string storage when NSString already keeps its content as UTF-8 or ASCII,
+/// otherwise converts it once into own buffer. Keeps the string alive.
+class RHUTF8Bytes {
+public:
+    explicit RHUTF8Bytes(NSString * _Nullable nsString);
+    RHUTF8Bytes(const RHUTF8Bytes &) = delete;
+    RHUTF8Bytes &operator=(const RHUTF8Bytes &) = delete;
+
+    const char * _Nonnull data() const;
+    std::size_t size() const;
+
+private:
+    NSString * _Nullable string;
+    const char * _Nonnull bytes;
+    std::size_t length;
+    std::unique_ptr<char[]> storage;
+};
+
 #endif /* NSString_stdStringAddtitons_h */
@@ -28,12 +28,10 @@
 
 #import "NSString+stdStringAddtitons.h"
 
-NSString *STDStringToNSString(std::string stdString) {
-    const char *cString = stdString.c_str();
-    if(cString == NULL) {
-        return @"";
-    }
-    return [NSString stringWithUTF8String:cString];
+NSString *STDStringToNSString(const std::string &stdString) {
+    return [[NSString alloc] initWithBytes:stdString.data()
+                                    length:stdString.size()
+                                  encoding:NSUTF8StringEncoding];
 }
 
 std::string NSStringToSTDString(NSString * _Nullable nsString) {
@@ -41,10 +39,44 @@ std::string NSStringToSTDString(NSString * _Nullable nsString) {
         return std::string();
     }
 
-    const char *utfString = nsString.UTF8String;
-    if(utfString == nil) {
-        return std::string();
+    const RHUTF8Bytes bytes(nsString);
+    return std::string(bytes.data(), bytes.size());
+}
+
+RHUTF8Bytes::RHUTF8Bytes(NSString * _Nullable nsString):
+    string(nsString),
+    bytes(""),
+    length(0) {
+    if(string.length == 0) {
+        return;
+    }
+    
+    const char *borrowed = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingUTF8);
+    if(borrowed != NULL) {
+        bytes = borrowed;
+        length = strlen(borrowed);
+        return;
     }
     
-    return utfString;
+    const NSUInteger size = [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    storage.reset(new char[size + 1]);
+    NSUInteger usedSize = 0;
+    [string getBytes:storage.get()
+           maxLength:size
+          usedLength:&usedSize
+            encoding:NSUTF8StringEncoding
+             options:0
+               range:NSMakeRange(0, string.length)
+      remainingRange:NULL];
+    storage[usedSize] = '\0';
+    bytes = storage.get();
+    length = usedSize;
+}
+
+const char *RHUTF8Bytes::data() const {
+    return bytes;
+}
+
+std::size_t RHUTF8Bytes::size() const {
+    return length;
 }
@@ -213,6 +213,7 @@ let package = Package(
                 ] + commonCSettings(prefix: "../Core/"),
                 linkerSettings: [
                     .linkedFramework("AVFoundation"),
+                    .linkedFramework("AudioToolbox"),
                     .linkedLibrary("z")
                 ]
                ),
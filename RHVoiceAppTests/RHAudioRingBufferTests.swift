@@ -0,0 +1,271 @@
+//
+//  RHAudioRingBufferTests.swift
+//  RHVoiceAppTests
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+import XCTest
+
+import RHVoice
+@testable import RHVoiceApp
+
+final class RHAudioRingBufferTests: XCTestCase {
+
+    /// 20 ms chunks at 24 kHz, that is what engine produces for the extension
+    private let chunkSize = 480
+    private let renderFrameCount = 512
+    private let sampleCount = 24000 * 60
+
+    func testCapacityIsRoundedUpToPowerOfTwo() {
+        XCTAssertEqual(RHAudioRingBuffer(capacity: 1000).capacity, 1024)
+        XCTAssertEqual(RHAudioRingBuffer(capacity: 1024).capacity, 1024)
+    }
+
+    func testReadConvertsToFloat() {
+        let systemUnderTest = RHAudioRingBuffer(capacity: 8)
+        let samples: [Int16] = [0, 16384, -16384, Int16.min]
+        XCTAssertTrue(systemUnderTest.writeSamples(samples, count: samples.count))
+        XCTAssertEqual(systemUnderTest.availableFrames, samples.count)
+
+        var frames = [Float](repeating: 1, count: 8)
+        XCTAssertEqual(systemUnderTest.readFrames(&frames, count: frames.count), samples.count)
+        XCTAssertEqual(Array(frames[0..<samples.count]), [0, 0.5, -0.5, -1])
+        XCTAssertEqual(systemUnderTest.availableFrames, 0)
+        XCTAssertFalse(systemUnderTest.isDrained)
+
+        systemUnderTest.finish()
+        XCTAssertTrue(systemUnderTest.isDrained)
+    }
+
+    func testCancelUnblocksProducer() {
+        let systemUnderTest = RHAudioRingBuffer(capacity: 16)
+        let samples = [Int16](repeating: 1, count: 64)
+
+        let producerFinished = expectation(description: "Producer finished")
+        DispatchQueue.global().async {
+            XCTAssertFalse(systemUnderTest.writeSamples(samples, count: samples.count))
+            producerFinished.fulfill()
+        }
+
+        Thread.sleep(forTimeInterval: 0.1)
+        systemUnderTest.cancel()
+        wait(for: [producerFinished], timeout: 1)
+    }
+
+    func testWaitForFramesReturnsAtDeadline() {
+        let systemUnderTest = RHAudioRingBuffer(capacity: 1024)
+        let timeout: TimeInterval = 0.05
+
+        let start = Date()
+        XCTAssertEqual(systemUnderTest.waitForFrames(renderFrameCount, timeout: timeout), 0)
+        XCTAssertGreaterThanOrEqual(Date().timeIntervalSince(start), timeout)
+    }
+
+    func testWaitForFramesReturnsWhenFinished() {
+        let systemUnderTest = RHAudioRingBuffer(capacity: 1024)
+        let samples = [Int16](repeating: 1, count: 10)
+        XCTAssertTrue(systemUnderTest.writeSamples(samples, count: samples.count))
+        systemUnderTest.finish()
+
+        let start = Date()
+        XCTAssertEqual(systemUnderTest.waitForFrames(renderFrameCount, timeout: 1), samples.count)
+        XCTAssertLessThan(Date().timeIntervalSince(start), 0.1)
+    }
+
+    /// Producer delivers a chunk every 20 ms, consumer sleeps until a full chunk is there.
+    /// Wakeup latency is time between the start of the write and return from the wait.
+    func testWaitForFramesWakeupLatency() throws {
+        try skipUnlessBenchmarking()
+        let systemUnderTest = RHAudioRingBuffer(capacity: 24000)
+        let chunkCount = 50
+        let chunk = [Int16](repeating: 1, count: chunkSize)
+        let lock = NSLock()
+        var writeTimes: [TimeInterval] = []
+
+        Thread.detachNewThread {
+            for _ in 0..<chunkCount {
+                Thread.sleep(forTimeInterval: 0.02)
+                lock.lock()
+                writeTimes.append(ProcessInfo.processInfo.systemUptime)
+                lock.unlock()
+                XCTAssertTrue(systemUnderTest.writeSamples(chunk, count: chunk.count))
+            }
+            systemUnderTest.finish()
+        }
+
+        var frames = [Float](repeating: 0, count: chunkSize)
+        var latencies: [TimeInterval] = []
+        while !systemUnderTest.isDrained {
+            let available = systemUnderTest.waitForFrames(chunkSize, timeout: 1)
+            let wokeUp = ProcessInfo.processInfo.systemUptime
+            guard available > 0 else {
+                continue
+            }
+            lock.lock()
+            let writeTime = writeTimes.last ?? wokeUp
+            lock.unlock()
+            latencies.append(max(wokeUp - writeTime, 0))
+            _ = systemUnderTest.readFrames(&frames, count: min(available, frames.count))
+        }
+
+        let mean = latencies.reduce(0, +) / Double(max(latencies.count, 1))
+        Log.debug(type: .tests, String(format: "Wakeup latency. Mean: %.1f us, max: %.1f us",
+                                               mean * 1_000_000,
+                                               (latencies.max() ?? 0) * 1_000_000))
+        XCTAssertFalse(latencies.isEmpty)
+        XCTAssertLessThan(mean, 0.01)
+    }
+
+    func testStress() throws {
+        try skipUnlessBenchmarking()
+        let systemUnderTest = RHAudioRingBuffer(capacity: 4096)
+        startProducer(buffer: systemUnderTest)
+
+        var frames = [Float](repeating: 0, count: renderFrameCount)
+        var received = 0
+        while !systemUnderTest.isDrained {
+            let count = systemUnderTest.readFrames(&frames, count: frames.count)
+            for index in 0..<count where frames[index] != expectedFrame(at: received + index) {
+                XCTFail("Unexpected frame at \(received + index)")
+                return
+            }
+            received += count
+        }
+
+        XCTAssertEqual(received, sampleCount)
+    }
+
+    func testThroughputAndJitter() throws {
+        try skipUnlessBenchmarking()
+        let ringBuffer = measureRingBuffer()
+        let queue = measureQueue()
+
+        Log.debug(type: .tests, "Ring buffer. \(ringBuffer)")
+        Log.debug(type: .tests, "Queue. \(queue)")
+
+        XCTAssertEqual(ringBuffer.frames, sampleCount)
+        XCTAssertEqual(queue.frames, sampleCount)
+    }
+}
+
+private extension RHAudioRingBufferTests {
+
+    struct RenderStatistics: CustomStringConvertible {
+        var frames = 0
+        var duration: TimeInterval = 0
+        var renderCallDurations: [TimeInterval] = []
+
+        var description: String {
+            let calls = Double(max(renderCallDurations.count, 1))
+            let mean = renderCallDurations.reduce(0, +) / calls
+            let variance = renderCallDurations.reduce(0) { $0 + ($1 - mean) * ($1 - mean) } / calls
+            let throughput = Double(frames) / max(duration, .leastNonzeroMagnitude)
+            return String(format: "Throughput: %.0f frames/s, render call mean: %.2f us, jitter(stddev): %.2f us, max: %.2f us",
+                          throughput,
+                          mean * 1_000_000,
+                          variance.squareRoot() * 1_000_000,
+                          (renderCallDurations.max() ?? 0) * 1_000_000)
+        }
+    }
+
+    func expectedFrame(at index: Int) -> Float {
+        return Float(Int16(truncatingIfNeeded: index)) / 32768
+    }
+
+    func makeChunk(from offset: Int, count: Int) -> [Int16] {
+        return (offset..<(offset + count)).map { Int16(truncatingIfNeeded: $0) }
+    }
+
+    func startProducer(buffer: RHAudioRingBuffer) {
+        let sampleCount = sampleCount
+        let chunkSize = chunkSize
+        Thread.detachNewThread { [self] in
+            var offset = 0
+            while offset < sampleCount {
+                let chunk = makeChunk(from: offset, count: min(chunkSize, sampleCount - offset))
+                guard buffer.writeSamples(chunk, count: chunk.count) else {
+                    return
+                }
+                offset += chunk.count
+            }
+            buffer.finish()
+        }
+    }
+
+    func measureRingBuffer() -> RenderStatistics {
+        let buffer = RHAudioRingBuffer(capacity: 24000 * 10)
+        var statistics = RenderStatistics()
+        var frames = [Float](repeating: 0, count: renderFrameCount)
+
+        let start = Date()
+        startProducer(buffer: buffer)
+        while !buffer.isDrained {
+            let callStart = Date()
+            statistics.frames += buffer.readFrames(&frames, count: frames.count)
+            statistics.renderCallDurations.append(Date().timeIntervalSince(callStart))
+        }
+        statistics.duration = Date().timeIntervalSince(start)
+        return statistics
+    }
+
+    /// Mirrors the previous extension path: samples are copied into a Swift array, converted and
+    /// appended to a shared array on a serial queue, render reads it with `sync`
+    func measureQueue() -> RenderStatistics {
+        let queue = DispatchQueue(label: "RHAudioRingBufferTests.outputDataQueue", qos: .userInteractive)
+        var outputData: [Float] = []
+        var isFinished = false
+        var outputOffset = 0
+        var statistics = RenderStatistics()
+        let sampleCount = sampleCount
+        let chunkSize = chunkSize
+
+        let start = Date()
+        Thread.detachNewThread { [self] in
+            var offset = 0
+            while offset < sampleCount {
+                let chunk = makeChunk(from: offset, count: min(chunkSize, sampleCount - offset))
+                queue.async {
+                    outputData.append(contentsOf: chunk.map { Float($0) / 32768 })
+                }
+                offset += chunk.count
+            }
+            queue.async {
+                isFinished = true
+            }
+        }
+
+        var isDrained = false
+        while !isDrained {
+            let callStart = Date()
+            var frames: [Float] = []
+            queue.sync {
+                let count = min(outputData.count - outputOffset, renderFrameCount)
+                frames = Array(outputData[outputOffset..<(outputOffset + count)])
+                isDrained = isFinished && outputOffset + count == outputData.count
+            }
+            outputOffset += frames.count
+            statistics.frames += frames.count
+            statistics.renderCallDurations.append(Date().timeIntervalSince(callStart))
+        }
+        statistics.duration = Date().timeIntervalSince(start)
+        return statistics
+    }
+}
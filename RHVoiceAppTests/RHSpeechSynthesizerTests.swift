@@ -37,7 +37,11 @@ final class RHSpeechSynthesizerTests: XCTestCase {
 
     var synthesizerFinishedSuccess: ((RHSpeechUtterance) -> Void)?
     var synthesizerFinishedFail: ((RHSpeechUtterance, Error?) -> Void)?
+    var synthesizerStartedSpeaking: ((RHSpeechUtterance) -> Void)?
+    var synthesizerBeganSynthesizing: ((RHSpeechUtterance) -> Void)?
     var clientReceivedMarker: (([RHSpeechSynthesisMarker]) -> Void)?
+    var clientReceivedSamples: ((Int) -> Void)?
+    var clientReceivedAudio: ((UnsafeBufferPointer<Int16>) -> Void)?
 
     override func setUpWithError() throws {
        try super.setUpWithError()
@@ -52,7 +56,11 @@ final class RHSpeechSynthesizerTests: XCTestCase {
         removeAllInstlledVoicesAndLangauges()
         synthesizerFinishedSuccess = nil
         synthesizerFinishedFail = nil
+        synthesizerStartedSpeaking = nil
+        synthesizerBeganSynthesizing = nil
         clientReceivedMarker = nil
+        clientReceivedSamples = nil
+        clientReceivedAudio = nil
         try super.tearDownWithError()
     }
 
@@ -157,6 +165,573 @@ final class RHSpeechSynthesizerTests: XCTestCase {
     }
 }
 
+extension RHSpeechSynthesizerTests {
+    func testFirstAudioLatency() throws {
+        try skipUnlessBenchmarking()
+        let (voice, _) = try instalAnyVoice()
+        let installedVoice = voice.installedVoice
+        guard let installedVoice else {
+            XCTFail("InstalledVoice:\(String(describing: installedVoice)) can't be nil")
+            return
+        }
+
+        guard let text = RHSpeechSynthesizerTestData.data.first?.text else {
+            XCTFail("No test data")
+            return
+        }
+
+        let fileLatency = try firstAudioLatencyUsingFile(text: text, voice: installedVoice)
+        let streamingLatency = try firstAudioLatencyUsingStreaming(text: text, voice: installedVoice)
+        Log.debug(type: .tests, "First audio latency. File: \(fileLatency)s, streaming: \(streamingLatency)s")
+
+        XCTAssertLessThan(streamingLatency, fileLatency)
+    }
+
+    /// With the file path the first sample can only be played once the whole file is written
+    func firstAudioLatencyUsingFile(text: String, voice: RHSpeechSynthesisVoice) throws -> TimeInterval {
+        let outputFilePath = FileManager.default.tempFile(with: "wav")
+        let utterance = RHSpeechUtterance(text: text)
+        utterance.set(voice: voice)
+
+        let finished = expectation(description: "Synthesizer Finished")
+        synthesizerFinishedSuccess = { _ in
+            finished.fulfill()
+        }
+
+        let start = Date()
+        synthesizerUnderTest?.synthesizeUtterance(utterance, toFileAtPath: outputFilePath)
+        wait(for: [finished], timeout: 3)
+        let result = Date().timeIntervalSince(start)
+
+        try FileManager.default.removeItem(atPath: outputFilePath)
+        return result
+    }
+
+    func firstAudioLatencyUsingStreaming(text: String, voice: RHSpeechSynthesisVoice) throws -> TimeInterval {
+        let utterance = RHSpeechUtterance(text: text)
+        utterance.set(voice: voice)
+
+        let started = expectation(description: "Synthesizer Started Speaking")
+        var result: TimeInterval = 0
+        let start = Date()
+        synthesizerStartedSpeaking = { _ in
+            result = Date().timeIntervalSince(start)
+            started.fulfill()
+        }
+
+        let finished = expectation(description: "Synthesizer Finished")
+        synthesizerFinishedSuccess = { _ in
+            finished.fulfill()
+        }
+
+        synthesizerUnderTest?.speak(utterance)
+        wait(for: [started], timeout: 3)
+        synthesizerUnderTest?.stopAndCancel()
+        wait(for: [finished], timeout: 3)
+
+        return result
+    }
+}
+
+extension RHSpeechSynthesizerTests {
+    func testParallelSynthesisRealTimeFactor() throws {
+        try skipUnlessBenchmarking()
+        let (voice, _) = try instalAnyVoice()
+        let installedVoice = voice.installedVoice
+        guard let installedVoice else {
+            XCTFail("InstalledVoice:\(String(describing: installedVoice)) can't be nil")
+            return
+        }
+
+        let text = Array(repeating: RHSpeechSynthesizerTestData.data.map { $0.text }.joined(separator: " "),
+                         count: 20).joined(separator: "\n")
+
+        var durations: [Int: AVAudioFramePosition] = [:]
+        for threadCount in [1, 2, 4] {
+            let (duration, seconds) = try synthesizeToFile(text: text, voice: installedVoice, threadCount: threadCount)
+            durations[threadCount] = duration
+            Log.debug(type: .tests, "Parallel synthesis. Threads: \(threadCount), real time factor: \(seconds / (Double(duration) / 24000.0))")
+        }
+
+        guard let serialDuration = durations[1] else {
+            XCTFail("No serial result")
+            return
+        }
+        for (_, duration) in durations {
+            XCTAssertEqual(Double(duration), Double(serialDuration), accuracy: Double(serialDuration) * 0.05)
+        }
+    }
+
+    func synthesizeToFile(text: String,
+                          voice: RHSpeechSynthesisVoice,
+                          threadCount: Int) throws -> (AVAudioFramePosition, TimeInterval) {
+        let outputFilePath = FileManager.default.tempFile(with: "wav")
+        let utterance = RHSpeechUtterance(text: text)
+        utterance.set(voice: voice)
+
+        let finished = expectation(description: "Synthesizer Finished")
+        synthesizerFinishedSuccess = { _ in
+            finished.fulfill()
+        }
+
+        synthesizerUnderTest?.parallelSynthesisThreadCount = UInt(threadCount)
+        let start = Date()
+        synthesizerUnderTest?.synthesizeUtterance(utterance, toFileAtPath: outputFilePath)
+        wait(for: [finished], timeout: 120)
+        let seconds = Date().timeIntervalSince(start)
+
+        let audioFile = try AVAudioFile(forReading: URL(fileURLWithPath: outputFilePath))
+        let length = audioFile.length
+        try FileManager.default.removeItem(atPath: outputFilePath)
+        return (length, seconds)
+    }
+}
+
+extension RHSpeechSynthesizerTests {
+    /// About 1 MB of text
+    var largeInputText: String {
+        let sentence = RHSpeechSynthesizerTestData.data.map { $0.text }.joined(separator: " ")
+        return Array(repeating: sentence, count: 1024 * 1024 / sentence.utf8.count + 1).joined(separator: "\n")
+    }
+
+    func testLargePlainTextIngestion() throws {
+        let voice = try installAnySpeechVoice()
+        let text = largeInputText
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()]) {
+            timeToFirstMarker(utterance: RHSpeechUtterance(text: text), voice: voice)
+        }
+    }
+
+    func testLargeSSMLIngestion() throws {
+        let voice = try installAnySpeechVoice()
+        let ssml = "<speak>\(largeInputText)</speak>"
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()]) {
+            timeToFirstMarker(utterance: RHSpeechUtterance(ssml: ssml), voice: voice)
+        }
+    }
+
+    /// Document has to be created, so the whole input is converted and parsed before the first marker
+    func timeToFirstMarker(utterance: RHSpeechUtterance, voice: RHSpeechSynthesisVoice) {
+        utterance.set(voice: voice)
+
+        let client = RHSpeechUtteranceClient(audioBufferSize: 20)
+        client.markerDelegate = self
+        utteranceClient = client
+
+        let receivedMarker = expectation(description: "Client Received Markers")
+        receivedMarker.assertForOverFulfill = false
+        clientReceivedMarker = { _ in
+            client.cancel()
+            receivedMarker.fulfill()
+        }
+
+        let finished = expectation(description: "Synthesizer Finished")
+        synthesizerFinishedSuccess = { _ in
+            finished.fulfill()
+        }
+
+        synthesizerUnderTest?.synthesizeUtterance(utterance, client: client)
+        wait(for: [receivedMarker, finished], timeout: 30)
+        clientReceivedMarker = nil
+    }
+}
+
+extension RHSpeechSynthesizerTests {
+    /// Long utterance is being rendered and background ones are queued when an interrupt comes.
+    /// Reports time from submitting the interrupt to its first audio.
+    func testInterruptLatencyUnderLoad() throws {
+        try skipUnlessBenchmarking()
+        let voice = try installAnySpeechVoice()
+        let longText = Array(repeating: RHSpeechSynthesizerTestData.data.map { $0.text }.joined(separator: " "),
+                             count: 50).joined(separator: "\n")
+
+        var latencies: [TimeInterval] = []
+        for _ in 0..<20 {
+            let longUtterance = RHSpeechUtterance(text: longText)
+            longUtterance.set(voice: voice)
+            let longClient = RHSpeechUtteranceClient(audioBufferSize: 20)
+
+            let interrupt = RHSpeechUtterance(text: "1.")
+            interrupt.set(voice: voice)
+            interrupt.priority = RHSpeechUtterancePriorityInterrupt
+
+            let longStarted = expectation(description: "Long Utterance Started")
+            let interruptStarted = expectation(description: "Interrupt Started")
+            var interruptSubmitted = Date()
+            synthesizerBeganSynthesizing = { utterance in
+                if utterance === longUtterance {
+                    longStarted.fulfill()
+                } else if utterance === interrupt {
+                    latencies.append(Date().timeIntervalSince(interruptSubmitted))
+                    interruptStarted.fulfill()
+                }
+            }
+
+            let finished = expectation(description: "Synthesizer Finished")
+            finished.expectedFulfillmentCount = 5
+            synthesizerFinishedSuccess = { _ in
+                finished.fulfill()
+            }
+
+            synthesizerUnderTest?.synthesizeUtterance(longUtterance, client: longClient)
+            for _ in 0..<3 {
+                let background = RHSpeechUtterance(text: longText)
+                background.set(voice: voice)
+                background.priority = RHSpeechUtterancePriorityBackground
+                synthesizerUnderTest?.synthesizeUtterance(background, client: RHSpeechUtteranceClient(audioBufferSize: 20))
+            }
+            wait(for: [longStarted], timeout: 30)
+
+            interruptSubmitted = Date()
+            synthesizerUnderTest?.synthesizeUtterance(interrupt, client: RHSpeechUtteranceClient(audioBufferSize: 20))
+            wait(for: [interruptStarted, finished], timeout: 30)
+            XCTAssertEqual(longClient.status(), RHSpeechUtteranceClientStatusCanceled)
+        }
+        synthesizerBeganSynthesizing = nil
+
+        let sorted = latencies.sorted()
+        let percentile = { (value: Double) -> TimeInterval in
+            sorted[min(sorted.count - 1, Int(Double(sorted.count) * value))]
+        }
+        Log.debug(type: .tests, "Interrupt latency under load. p50: \(percentile(0.5))s, p90: \(percentile(0.9))s, p99: \(percentile(0.99))s")
+    }
+}
+
+extension RHSpeechSynthesizerTests {
+    /// Reports time from `stopAndCancel` to `didFinish` while a long utterance is being synthesized
+    func testCancelLatencyOnLongInput() throws {
+        try skipUnlessBenchmarking()
+        let voice = try installAnySpeechVoice()
+        let longText = Array(repeating: RHSpeechSynthesizerTestData.data.map { $0.text }.joined(separator: " "),
+                             count: 200).joined(separator: "\n")
+
+        for threadCount in [1, 4] {
+            synthesizerUnderTest?.parallelSynthesisThreadCount = UInt(threadCount)
+            var latencies: [TimeInterval] = []
+            for _ in 0..<20 {
+                let utterance = RHSpeechUtterance(text: longText)
+                utterance.set(voice: voice)
+                let client = RHSpeechUtteranceClient(audioBufferSize: 20)
+
+                let started = expectation(description: "Synthesizer Started")
+                synthesizerBeganSynthesizing = { _ in
+                    started.fulfill()
+                }
+                var cancelled = Date()
+                let finished = expectation(description: "Synthesizer Finished")
+                synthesizerFinishedSuccess = { _ in
+                    latencies.append(Date().timeIntervalSince(cancelled))
+                    finished.fulfill()
+                }
+
+                synthesizerUnderTest?.synthesizeUtterance(utterance, client: client)
+                wait(for: [started], timeout: 30)
+                cancelled = Date()
+                synthesizerUnderTest?.stopAndCancel()
+                wait(for: [finished], timeout: 30)
+                XCTAssertEqual(client.status(), RHSpeechUtteranceClientStatusCanceled)
+            }
+            synthesizerBeganSynthesizing = nil
+
+            let sorted = latencies.sorted()
+            Log.debug(type: .tests, "Cancel latency. Threads: \(threadCount), p50: \(sorted[sorted.count / 2])s, max: \(sorted[sorted.count - 1])s")
+        }
+    }
+}
+
+extension RHSpeechSynthesizerTests {
+    /// Paragraphs are requested one by one, each after the previous one played for a second.
+    /// Reports time from request to the first audio of every paragraph after the first one.
+    func testContinuousReadingGaps() throws {
+        try skipUnlessBenchmarking()
+        let voice = try installAnySpeechVoice()
+        let sentence = RHSpeechSynthesizerTestData.data.map { $0.text }.joined(separator: " ")
+        let paragraphs = (1...6).map { "\($0). \(sentence)" }
+
+        synthesizerUnderTest?.utteranceCache = RHUtteranceCache(memoryCapacity: 32 * 1024 * 1024)
+        let gaps = continuousReadingGaps(paragraphs: paragraphs, voice: voice, preSynthesize: false)
+        synthesizerUnderTest?.utteranceCache = RHUtteranceCache(memoryCapacity: 32 * 1024 * 1024)
+        let preSynthesizedGaps = continuousReadingGaps(paragraphs: paragraphs, voice: voice, preSynthesize: true)
+
+        let average = { (values: [TimeInterval]) -> TimeInterval in
+            values.reduce(0, +) / Double(values.count)
+        }
+        Log.debug(type: .tests, "Continuous reading gaps. Average: \(average(gaps))s, max: \(gaps.max() ?? 0)s. " +
+                                "With pre-synthesis average: \(average(preSynthesizedGaps))s, max: \(preSynthesizedGaps.max() ?? 0)s")
+        XCTAssertLessThan(average(preSynthesizedGaps), average(gaps))
+    }
+
+    func continuousReadingGaps(paragraphs: [String],
+                               voice: RHSpeechSynthesisVoice,
+                               preSynthesize: Bool) -> [TimeInterval] {
+        let utterances = paragraphs.map { paragraph -> RHSpeechUtterance in
+            let utterance = RHSpeechUtterance(text: paragraph)
+            utterance.set(voice: voice)
+            return utterance
+        }
+
+        var gaps: [TimeInterval] = []
+        for (index, utterance) in utterances.enumerated() {
+            let started = expectation(description: "Synthesizer Started")
+            var requested = Date()
+            synthesizerBeganSynthesizing = { _ in
+                if index > 0 {
+                    gaps.append(Date().timeIntervalSince(requested))
+                }
+                started.fulfill()
+            }
+            let finished = expectation(description: "Synthesizer Finished")
+            synthesizerFinishedSuccess = { _ in
+                finished.fulfill()
+            }
+
+            requested = Date()
+            synthesizerUnderTest?.synthesizeUtterance(utterance, client: RHSpeechUtteranceClient(audioBufferSize: 20))
+            if preSynthesize && index + 1 < utterances.count {
+                synthesizerUnderTest?.preSynthesizeUtterance(utterances[index + 1])
+            }
+            wait(for: [started, finished], timeout: 30)
+            /// Playback of the paragraph
+            Thread.sleep(forTimeInterval: 1)
+        }
+        synthesizerBeganSynthesizing = nil
+        return gaps
+    }
+}
+
+extension RHSpeechSynthesizerTests {
+    func testTracingOverheadAndExport() throws {
+        let voice = try installAnySpeechVoice()
+        let text = Array(repeating: RHSpeechSynthesizerTestData.data.map { $0.text }.joined(separator: " "),
+                         count: 10).joined(separator: "\n")
+
+        var untracedSeconds: TimeInterval = 0
+        var tracedSeconds: TimeInterval = 0
+        for _ in 0..<3 {
+            RHVoiceBridge.sharedInstance().setTracingEnabled(false)
+            untracedSeconds += try synthesizeToFile(text: text, voice: voice, threadCount: 1).1
+            RHVoiceBridge.sharedInstance().setTracingEnabled(true)
+            tracedSeconds += try synthesizeToFile(text: text, voice: voice, threadCount: 1).1
+        }
+        RHVoiceBridge.sharedInstance().setTracingEnabled(false)
+        Log.debug(type: .tests, "Tracing overhead: \((tracedSeconds / untracedSeconds - 1) * 100)%")
+
+        let tracePath = FileManager.default.tempFile(with: "json")
+        XCTAssertTrue(RHVoiceBridge.sharedInstance().writeTrace(toPath: tracePath))
+        let data = try Data(contentsOf: URL(fileURLWithPath: tracePath))
+        try FileManager.default.removeItem(atPath: tracePath)
+
+        let trace = try XCTUnwrap(try JSONSerialization.jsonObject(with: data) as? [String: Any])
+        let events = try XCTUnwrap(trace["traceEvents"] as? [[String: Any]])
+        let names = Set(events.compactMap { $0["name"] as? String })
+        for name in ["scheduler.wait", "document.create", "document.synthesize", "client.play_speech", "client.first_audio"] {
+            XCTAssertTrue(names.contains(name), "Trace has no \(name) events")
+        }
+    }
+}
+
+extension RHSpeechSynthesizerTests {
+    /// Text arrives at a fixed byte rate, like a caption feed. Reports time from the first chunk to the first audio
+    func testStreamedTextAudioStartLatency() throws {
+        let voice = try installAnySpeechVoice()
+        let text = Array(repeating: RHSpeechSynthesizerTestData.data[0].text, count: 3).joined(separator: " ")
+        let bytes = Array(text.utf8)
+        let chunkSize = 16
+        let chunkInterval: TimeInterval = 0.05
+        let feedDuration = Double(bytes.count / chunkSize) * chunkInterval
+
+        let stream = RHSpeechTextStream()
+        let utterance = RHSpeechUtterance(textStream: stream)
+        utterance.set(voice: voice)
+        utteranceClient = RHSpeechUtteranceClient(audioBufferSize: 20)
+        utteranceClient?.markerDelegate = self
+
+        let firstAudio = expectation(description: "Client Received Audio")
+        firstAudio.assertForOverFulfill = false
+        var sampleCount = 0
+        clientReceivedSamples = { count in
+            sampleCount += count
+            firstAudio.fulfill()
+        }
+        let finished = expectation(description: "Synthesizer Finished")
+        synthesizerFinishedSuccess = { _ in
+            finished.fulfill()
+        }
+
+        synthesizerUnderTest?.synthesizeUtterance(utterance, client: utteranceClient!)
+        let start = Date()
+        DispatchQueue.global().async {
+            var offset = 0
+            while offset < bytes.count {
+                let end = min(offset + chunkSize, bytes.count)
+                /// Chunks are cut at code points, as a text feed would send them
+                var chunkEnd = end
+                while chunkEnd < bytes.count && bytes[chunkEnd] & 0xC0 == 0x80 {
+                    chunkEnd += 1
+                }
+                stream.appendText(String(decoding: bytes[offset..<chunkEnd], as: UTF8.self))
+                offset = chunkEnd
+                Thread.sleep(forTimeInterval: chunkInterval)
+            }
+            stream.finish()
+        }
+
+        wait(for: [firstAudio], timeout: feedDuration + 10)
+        let latency = Date().timeIntervalSince(start)
+        wait(for: [finished], timeout: feedDuration + 30)
+
+        let wholeTextLatency = feedDuration + (try firstAudioLatencyUsingStreaming(text: text, voice: voice))
+        Log.debug(type: .tests, "Streamed text audio start latency: \(latency)s, waiting for the whole text: \(wholeTextLatency)s")
+
+        XCTAssertGreaterThan(sampleCount, 0)
+        XCTAssertLessThan(latency, feedDuration)
+    }
+}
+
+extension RHSpeechSynthesizerTests {
+    /// Converts an audiobook sized text to every file format and reports size, CPU time and throughput.
+    /// Encoding CPU on top of synthesis is the difference from WAV.
+    func testSynthesizeToCompressedFiles() throws {
+        try skipUnlessBenchmarking()
+        let voice = try installAnySpeechVoice()
+        let text = Array(repeating: RHSpeechSynthesizerTestData.data.map { $0.text }.joined(separator: " "),
+                         count: 100).joined(separator: "\n")
+
+        let formats: [(String, RHSpeechAudioFileFormat, String)] = [
+            ("WAV", RHSpeechAudioFileFormatWAV, "wav"),
+            ("FLAC", RHSpeechAudioFileFormatFLAC, "flac"),
+            ("Opus", RHSpeechAudioFileFormatOpus, "caf")
+        ]
+
+        var results: [String: (length: AVAudioFramePosition, bytes: UInt64)] = [:]
+        for (name, format, ext) in formats {
+            let outputFilePath = FileManager.default.tempFile(with: ext)
+            let utterance = RHSpeechUtterance(text: text)
+            utterance.set(voice: voice)
+
+            let finished = expectation(description: "Synthesizer Finished")
+            synthesizerFinishedSuccess = { _ in
+                finished.fulfill()
+            }
+
+            let startCPU = clock()
+            let start = Date()
+            synthesizerUnderTest?.synthesizeUtterance(utterance, toFileAtPath: outputFilePath, format: format)
+            wait(for: [finished], timeout: 600)
+            let seconds = Date().timeIntervalSince(start)
+            let cpuSeconds = Double(clock() - startCPU) / Double(CLOCKS_PER_SEC)
+
+            let audioFile = try AVAudioFile(forReading: URL(fileURLWithPath: outputFilePath))
+            let length = audioFile.length
+            let attributes = try FileManager.default.attributesOfItem(atPath: outputFilePath)
+            let bytes = (attributes[.size] as? NSNumber)?.uint64Value ?? 0
+            try FileManager.default.removeItem(atPath: outputFilePath)
+
+            results[name] = (length, bytes)
+            let audioSeconds = Double(length) / audioFile.fileFormat.sampleRate
+            Log.debug(type: .tests, "File format: \(name), bytes written: \(bytes), CPU: \(cpuSeconds)s, " +
+                                    "audio seconds per second: \(audioSeconds / seconds)")
+        }
+
+        let wav = try XCTUnwrap(results["WAV"])
+        let flac = try XCTUnwrap(results["FLAC"])
+        let opus = try XCTUnwrap(results["Opus"])
+        XCTAssertGreaterThan(wav.length, 0)
+        XCTAssertEqual(flac.length, wav.length)
+        XCTAssertEqual(Double(opus.length), Double(wav.length), accuracy: Double(wav.length) * 0.01)
+        XCTAssertLessThan(flac.bytes, wav.bytes)
+        XCTAssertLessThan(opus.bytes, flac.bytes)
+    }
+}
+
+extension RHSpeechSynthesizerTests {
+    /// Streamed text is split into documents at sentence ends. Abbreviations must not end a sentence,
+    /// otherwise engine loses the context it expands them and the following numbers with.
+    func testAbbreviationsDoNotSplitStreamedText() throws {
+        let voice = try installAnySpeechVoice(languageCode: "ru")
+        let texts = [
+            "Это, т.е. это пример простого текста.",
+            "В 2024 г. в Москве прошёл фестиваль.",
+            "Он живёт на ул. Ленина в доме пять.",
+            "Стихи А. С. Пушкина знают все."
+        ]
+
+        for text in texts {
+            let whole = try synthesizeToSamples(utterance: RHSpeechUtterance(text: text), voice: voice)
+            let stream = RHSpeechTextStream()
+            stream.appendText(text)
+            stream.finish()
+            let streamed = try synthesizeToSamples(utterance: RHSpeechUtterance(textStream: stream), voice: voice)
+
+            XCTAssertFalse(whole.isEmpty, text)
+            XCTAssertEqual(streamed, whole, text)
+        }
+    }
+
+    func synthesizeToSamples(utterance: RHSpeechUtterance, voice: RHSpeechSynthesisVoice) throws -> [Int16] {
+        utterance.set(voice: voice)
+        utteranceClient = RHSpeechUtteranceClient(audioBufferSize: 20)
+        utteranceClient?.markerDelegate = self
+
+        var result: [Int16] = []
+        clientReceivedAudio = { samples in
+            result.append(contentsOf: samples)
+        }
+        let finished = expectation(description: "Synthesizer Finished")
+        synthesizerFinishedSuccess = { _ in
+            finished.fulfill()
+        }
+
+        synthesizerUnderTest?.synthesizeUtterance(utterance, client: utteranceClient!)
+        wait(for: [finished], timeout: 10)
+        clientReceivedAudio = nil
+        return result
+    }
+}
+
+extension RHSpeechSynthesizerTests {
+    /// Marker ranges are converted from engine's UTF-8 offsets through a checkpoint index.
+    /// Compares them with NSString's own UTF-16 view of the text: every range has to lie within one word
+    /// and cover whole composed character sequences, also across many checkpoint intervals.
+    func testMarkerRangesMatchUTF16Text() throws {
+        let voice = try installAnySpeechVoice()
+        let words = ["cafe\u{301}", "👨‍👩‍👧‍👦", "👍🏽", "❤️", "🇺🇦", "nai\u{308}ve", "Ёлка", "smile😆", "a\u{330}\u{301}b", "test"]
+        /// Prefixes of growing length shift words against checkpoint boundaries
+        let text = (1...40).map { index in
+            String(repeating: "x", count: index % 7 + 1) + " " + words.joined(separator: " ")
+        }.joined(separator: " ")
+
+        let utterance = RHSpeechUtterance(text: text)
+        let ssml = try XCTUnwrap(utterance.ssml) as NSString
+        let textRange = ssml.range(of: text)
+        XCTAssertNotEqual(textRange.location, NSNotFound)
+
+        var wordRanges: [NSRange] = []
+        var location = textRange.location
+        for word in text.components(separatedBy: " ") {
+            let length = (word as NSString).length
+            wordRanges.append(NSRange(location: location, length: length))
+            location += length + 1
+        }
+
+        var markerRanges: [NSRange] = []
+        clientReceivedMarker = { markers in
+            markerRanges.append(contentsOf: markers.filter { $0.mark == RHSpeechSynthesisMarkerMarkWord }.map { $0.textRange })
+        }
+        _ = try synthesizeToSamples(utterance: utterance, voice: voice)
+        clientReceivedMarker = nil
+
+        XCTAssertFalse(markerRanges.isEmpty)
+        XCTAssertGreaterThan(markerRanges.map { NSMaxRange($0) }.max() ?? 0, textRange.location + textRange.length / 2)
+        for range in markerRanges {
+            XCTAssertEqual(ssml.rangeOfComposedCharacterSequences(for: range), range,
+                           "\(range) splits a character of '\(ssml.substring(with: range))'")
+            XCTAssertTrue(wordRanges.contains { NSIntersectionRange($0, range) == range },
+                          "\(range) is not within one word: '\(ssml.substring(with: range))'")
+        }
+    }
+}
+
 extension RHSpeechSynthesizerTests: RHSpeechSynthesizerDelegate {
     func speechSynthesizer(_ speechSynthesizer: RHSpeechSynthesizer, didFinish utterance: RHSpeechUtterance) {
         synthesizerFinishedSuccess?(utterance)
@@ -165,6 +740,14 @@ extension RHSpeechSynthesizerTests: RHSpeechSynthesizerDelegate {
     func speechSynthesizer(_ speechSynthesizer: RHSpeechSynthesizer, didFailToSynthesize utterance: RHSpeechUtterance, withError error: Error?) {
         synthesizerFinishedFail?(utterance, error)
     }
+
+    func speechSynthesizer(_ speechSynthesizer: RHSpeechSynthesizer, didStartSpeaking utterance: RHSpeechUtterance) {
+        synthesizerStartedSpeaking?(utterance)
+    }
+
+    func speechSynthesizer(_ speechSynthesizer: RHSpeechSynthesizer, didBeginSynthesizing utterance: RHSpeechUtterance) {
+        synthesizerBeganSynthesizing?(utterance)
+    }
 }
 
 extension RHSpeechSynthesizerTests: RHSpeechUtteranceClientMarkerDelegate {
@@ -172,5 +755,7 @@ extension RHSpeechSynthesizerTests: RHSpeechUtteranceClientMarkerDelegate {
         clientReceivedMarker?(markers)
     }
     func utteranceClientDidReceiveSamples(_ samples: UnsafePointer<Int16>, withSize count: Int) {
+        clientReceivedSamples?(count)
+        clientReceivedAudio?(UnsafeBufferPointer(start: samples, count: count))
     }
 }
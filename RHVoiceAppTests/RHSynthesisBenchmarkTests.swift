@@ -0,0 +1,284 @@
+//
+//  RHSynthesisBenchmarkTests.swift
+//  RHVoiceAppTests
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+import XCTest
+import Darwin
+
+import RHVoice
+@testable import RHVoiceApp
+
+/// End to end synthesis benchmark over a fixed corpus with the bundled `custom-voices/vladislav` voice.
+/// Results are written as JSON to `RHVOICE_BENCHMARK_OUTPUT` (or a temporary file) and attached to the test result,
+/// so runs on different revisions can be compared.
+final class RHSynthesisBenchmarkTests: XCTestCase {
+
+    struct UtteranceResult: Codable {
+        let text: String
+        let timeToFirstSample: TimeInterval
+        let latency: TimeInterval
+        let audioDuration: TimeInterval
+    }
+
+    struct RunResult: Codable {
+        let quality: String
+        let rate: Double
+        let realTimeFactor: Double
+        let timeToFirstSampleP50: TimeInterval
+        let timeToFirstSampleP99: TimeInterval
+        let latencyP50: TimeInterval
+        let latencyP99: TimeInterval
+        /// How much the process peak resident size rose during this run. Zero if an earlier run reached higher
+        let peakResidentGrowthBytes: UInt64
+        let peakAllocatedBytes: Int64
+        let liveBlocksGrowth: Int64
+        let utterances: [UtteranceResult]
+    }
+
+    struct Report: Codable {
+        let date: Date
+        let voice: String
+        let sampleRate: Double
+        /// Peak resident size of the whole process, including engine start and all runs
+        let peakResidentBytes: UInt64
+        let runs: [RunResult]
+    }
+
+    private let sampleRate = 24000.0
+
+    private let corpus: [String] = [
+        "Привет.",
+        "Съешь же ещё этих мягких французских булок, да выпей чаю.",
+        "В четверг, 12 марта 2024 года, в 14:30 поезд № 745 отправился из Москвы в Санкт-Петербург.",
+        "This is a test message.",
+        "Eu consegui falar um pouco de português muitos, muitos anos atrás.",
+        """
+        Широкая электрификация южных губерний даст мощный толчок подъёму сельского хозяйства. \
+        Эх, чужак, общий съём цен шляп (юфть) — вдрызг! Любя, съешь щипцы, — вздохнёт мэр, — кайф жгуч.
+        """
+    ]
+
+    private let qualities: [(String, RHSpeechUtteranceQuality)] = [
+        ("min", RHSpeechUtteranceQualityMin),
+        ("standard", RHSpeechUtteranceQualityStandart),
+        ("max", RHSpeechUtteranceQualityMax)
+    ]
+    private let rates: [Double] = [0.5, 1.0, 2.0]
+    private let repetitions = 5
+
+    var synthesizerUnderTest: RHSpeechSynthesizer?
+    var utteranceClient: RHSpeechUtteranceClient?
+    var synthesizerFinished: (() -> Void)?
+    var clientReceivedSamples: ((Int) -> Void)?
+
+    override func setUpWithError() throws {
+        try super.setUpWithError()
+        try skipUnlessBenchmarking()
+        removeAllInstlledVoicesAndLangauges()
+        synthesizerUnderTest = RHSpeechSynthesizer()
+        synthesizerUnderTest?.delegate = self
+    }
+
+    override func tearDownWithError() throws {
+        synthesizerUnderTest = nil
+        utteranceClient = nil
+        synthesizerFinished = nil
+        clientReceivedSamples = nil
+        removeAllInstlledVoicesAndLangauges()
+        try super.tearDownWithError()
+    }
+
+    func testSynthesisBenchmark() throws {
+        let voice = try installCustomVoice()
+
+        // Voice data loading is measured by RHVoiceEngineWarmUpTests
+        _ = try synthesize(text: corpus[0], voice: voice, quality: RHSpeechUtteranceQualityStandart, rate: 1.0)
+
+        var runs: [RunResult] = []
+        for (qualityName, quality) in qualities {
+            for rate in rates {
+                let run = try benchmark(voice: voice, qualityName: qualityName, quality: quality, rate: rate)
+                Log.debug(type: .tests, "Benchmark. Quality: \(qualityName), rate: \(rate), real time factor: \(run.realTimeFactor), " +
+                                        "first sample p50/p99: \(run.timeToFirstSampleP50)s/\(run.timeToFirstSampleP99)s, " +
+                                        "latency p50/p99: \(run.latencyP50)s/\(run.latencyP99)s, " +
+                                        "peak RSS growth: \(run.peakResidentGrowthBytes), peak allocated: \(run.peakAllocatedBytes)")
+                runs.append(run)
+            }
+        }
+
+        let report = Report(date: Date(),
+                            voice: customVoiceName,
+                            sampleRate: sampleRate,
+                            peakResidentBytes: peakResidentBytes(),
+                            runs: runs)
+        let url = try writeReport(report)
+        Log.debug(type: .tests, "Benchmark report: \(url.path)")
+        let attachment = XCTAttachment(contentsOfFile: url)
+        attachment.lifetime = .keepAlways
+        add(attachment)
+
+        for run in runs {
+            XCTAssertGreaterThan(run.realTimeFactor, 0)
+            XCTAssertTrue(run.utterances.allSatisfy { $0.audioDuration > 0 })
+        }
+    }
+
+    private func benchmark(voice: RHSpeechSynthesisVoice,
+                           qualityName: String,
+                           quality: RHSpeechUtteranceQuality,
+                           rate: Double) throws -> RunResult {
+        let startAllocations = MallocStatistics.current
+        let startPeakResident = peakResidentBytes()
+        var peakAllocatedBytes: Int64 = 0
+        var utterances: [UtteranceResult] = []
+
+        for _ in 0..<repetitions {
+            for text in corpus {
+                utterances.append(try synthesize(text: text, voice: voice, quality: quality, rate: rate) {
+                    peakAllocatedBytes = max(peakAllocatedBytes, MallocStatistics.current.bytes - startAllocations.bytes)
+                })
+            }
+        }
+
+        let endAllocations = MallocStatistics.current
+        let synthesisTime = utterances.reduce(0) { $0 + $1.latency }
+        let audioDuration = utterances.reduce(0) { $0 + $1.audioDuration }
+        let timesToFirstSample = utterances.map { $0.timeToFirstSample }.sorted()
+        let latencies = utterances.map { $0.latency }.sorted()
+
+        return RunResult(quality: qualityName,
+                         rate: rate,
+                         realTimeFactor: synthesisTime / audioDuration,
+                         timeToFirstSampleP50: percentile(timesToFirstSample, 0.5),
+                         timeToFirstSampleP99: percentile(timesToFirstSample, 0.99),
+                         latencyP50: percentile(latencies, 0.5),
+                         latencyP99: percentile(latencies, 0.99),
+                         peakResidentGrowthBytes: max(peakResidentBytes(), startPeakResident) - startPeakResident,
+                         peakAllocatedBytes: peakAllocatedBytes,
+                         liveBlocksGrowth: endAllocations.blocks - startAllocations.blocks,
+                         utterances: utterances)
+    }
+
+    private func synthesize(text: String,
+                            voice: RHSpeechSynthesisVoice,
+                            quality: RHSpeechUtteranceQuality,
+                            rate: Double,
+                            onSamples: (() -> Void)? = nil) throws -> UtteranceResult {
+        let utterance = RHSpeechUtterance(text: text)
+        utterance.set(voice: voice)
+        utterance.quality = quality
+        utterance.rate = rate
+
+        let finished = expectation(description: "Synthesizer Finished")
+        synthesizerFinished = {
+            finished.fulfill()
+        }
+
+        var firstSample: Date?
+        var sampleCount = 0
+        clientReceivedSamples = { count in
+            if firstSample == nil {
+                firstSample = Date()
+            }
+            sampleCount += count
+            onSamples?()
+        }
+
+        utteranceClient = RHSpeechUtteranceClient(audioBufferSize: 20)
+        utteranceClient?.markerDelegate = self
+        let start = Date()
+        synthesizerUnderTest?.synthesizeUtterance(utterance, client: utteranceClient!)
+        wait(for: [finished], timeout: 60)
+        let end = Date()
+
+        return UtteranceResult(text: text,
+                               timeToFirstSample: (firstSample ?? end).timeIntervalSince(start),
+                               latency: end.timeIntervalSince(start),
+                               audioDuration: Double(sampleCount) / sampleRate)
+    }
+
+    private func percentile(_ sorted: [TimeInterval], _ value: Double) -> TimeInterval {
+        guard !sorted.isEmpty else {
+            return 0
+        }
+        return sorted[min(sorted.count - 1, Int(Double(sorted.count) * value))]
+    }
+
+    private func peakResidentBytes() -> UInt64 {
+        var info = task_vm_info_data_t()
+        var count = mach_msg_type_number_t(MemoryLayout<task_vm_info_data_t>.size / MemoryLayout<natural_t>.size)
+        let result = withUnsafeMutablePointer(to: &info) {
+            $0.withMemoryRebound(to: integer_t.self, capacity: Int(count)) {
+                task_info(mach_task_self_, task_flavor_t(TASK_VM_INFO), $0, &count)
+            }
+        }
+        return result == KERN_SUCCESS ? info.resident_size_peak : 0
+    }
+
+    private func writeReport(_ report: Report) throws -> URL {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+        encoder.dateEncodingStrategy = .iso8601
+
+        let url: URL
+        if let path = ProcessInfo.processInfo.environment["RHVOICE_BENCHMARK_OUTPUT"], !path.isEmpty {
+            url = URL(fileURLWithPath: path)
+        } else {
+            url = URL(fileURLWithPath: FileManager.default.tempFile(with: "json"))
+        }
+        try encoder.encode(report).write(to: url)
+        return url
+    }
+
+}
+
+private struct MallocStatistics {
+    let bytes: Int64
+    let blocks: Int64
+
+    static var current: MallocStatistics {
+        var statistics = malloc_statistics_t()
+        malloc_zone_statistics(nil, &statistics)
+        return MallocStatistics(bytes: Int64(statistics.size_in_use), blocks: Int64(statistics.blocks_in_use))
+    }
+}
+
+extension RHSynthesisBenchmarkTests: RHSpeechSynthesizerDelegate {
+    func speechSynthesizer(_ speechSynthesizer: RHSpeechSynthesizer, didFinish utterance: RHSpeechUtterance) {
+        synthesizerFinished?()
+    }
+
+    func speechSynthesizer(_ speechSynthesizer: RHSpeechSynthesizer, didFailToSynthesize utterance: RHSpeechUtterance, withError error: Error?) {
+        XCTFail("Failed to synthesize: \(String(describing: error))")
+        synthesizerFinished?()
+    }
+}
+
+extension RHSynthesisBenchmarkTests: RHSpeechUtteranceClientMarkerDelegate {
+    func utteranceClientDidReceive(_ markers: [RHSpeechSynthesisMarker]) {
+    }
+
+    func utteranceClientDidReceiveSamples(_ samples: UnsafePointer<Int16>, withSize count: Int) {
+        clientReceivedSamples?(count)
+    }
+}
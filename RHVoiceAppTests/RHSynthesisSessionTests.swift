@@ -0,0 +1,156 @@
+//
+//  RHSynthesisSessionTests.swift
+//  RHVoiceAppTests
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+import XCTest
+import AVFAudio
+
+import RHVoice
+@testable import RHVoiceApp
+
+/// Several synthesizers sharing one engine. RHVoiceAppThreadSanitizer test plan runs these with Thread Sanitizer enabled.
+final class RHSynthesisSessionTests: XCTestCase {
+
+    final class SessionObserver: NSObject, RHSpeechSynthesizerDelegate {
+        let finished: XCTestExpectation
+
+        init(finished: XCTestExpectation) {
+            self.finished = finished
+        }
+
+        func speechSynthesizer(_ speechSynthesizer: RHSpeechSynthesizer, didFinish utterance: RHSpeechUtterance) {
+            finished.fulfill()
+        }
+
+        func speechSynthesizer(_ speechSynthesizer: RHSpeechSynthesizer, didFailToSynthesize utterance: RHSpeechUtterance, withError error: Error?) {
+            XCTFail("Failed to synthesize: \(String(describing: error))")
+            finished.fulfill()
+        }
+    }
+
+    private let utterancesPerSession = 3
+
+    override func setUpWithError() throws {
+        try super.setUpWithError()
+        removeAllInstlledVoicesAndLangauges()
+    }
+
+    override func tearDownWithError() throws {
+        removeAllInstlledVoicesAndLangauges()
+        try super.tearDownWithError()
+    }
+
+    /// Small enough to run on every test run and under Thread Sanitizer (RHVoiceAppThreadSanitizer test plan)
+    func testConcurrentSessionsMatchSingleSession() throws {
+        let (voice, _) = try instalAnyVoice()
+        let installedVoice = try XCTUnwrap(voice.installedVoice)
+        let text = try XCTUnwrap(RHSpeechSynthesizerTestData.data.first).text
+
+        let referencePath = FileManager.default.tempFile(with: "wav")
+        _ = try synthesize(text: text, voice: installedVoice, sessionCount: 1, utteranceCount: 1, keeping: referencePath)
+        let reference = try Data(contentsOf: URL(fileURLWithPath: referencePath))
+        try FileManager.default.removeItem(atPath: referencePath)
+
+        let (outputs, _) = try synthesize(text: text, voice: installedVoice, sessionCount: 2, utteranceCount: 2)
+        XCTAssertEqual(outputs.count, 4)
+        for output in outputs {
+            XCTAssertEqual(output, reference)
+        }
+    }
+
+    /// Every session has to produce exactly the audio a single synthesizer does
+    func testConcurrentSessionsThroughput() throws {
+        try skipUnlessBenchmarking()
+        let (voice, _) = try instalAnyVoice()
+        let installedVoice = try XCTUnwrap(voice.installedVoice)
+        let text = RHSpeechSynthesizerTestData.data.map { $0.text }.joined(separator: " ")
+
+        let referencePath = FileManager.default.tempFile(with: "wav")
+        _ = try synthesize(text: text, voice: installedVoice, sessionCount: 1, utteranceCount: 1, keeping: referencePath)
+        let reference = try Data(contentsOf: URL(fileURLWithPath: referencePath))
+        let referenceDuration = Double(try AVAudioFile(forReading: URL(fileURLWithPath: referencePath)).length) / 24000.0
+        try FileManager.default.removeItem(atPath: referencePath)
+
+        var throughputs: [Int: Double] = [:]
+        for sessionCount in [1, 2, 4, 8] {
+            let (outputs, seconds) = try synthesize(text: text,
+                                                    voice: installedVoice,
+                                                    sessionCount: sessionCount,
+                                                    utteranceCount: utterancesPerSession)
+            XCTAssertEqual(outputs.count, sessionCount * utterancesPerSession)
+            for output in outputs {
+                XCTAssertEqual(output, reference)
+            }
+            let throughput = Double(outputs.count) * referenceDuration / seconds
+            throughputs[sessionCount] = throughput
+            Log.debug(type: .tests, "Concurrent sessions: \(sessionCount), audio seconds per second: \(throughput)")
+        }
+
+        if ProcessInfo.processInfo.activeProcessorCount > 1, let serial = throughputs[1], let parallel = throughputs[2] {
+            XCTAssertGreaterThan(parallel, serial)
+        }
+    }
+
+    private func synthesize(text: String,
+                            voice: RHSpeechSynthesisVoice,
+                            sessionCount: Int,
+                            utteranceCount: Int,
+                            keeping keptPath: String? = nil) throws -> (outputs: [Data], seconds: TimeInterval) {
+        var expectations: [XCTestExpectation] = []
+        var observers: [SessionObserver] = []
+        var synthesizers: [RHSpeechSynthesizer] = []
+        var paths: [String] = []
+
+        let start = Date()
+        for session in 0..<sessionCount {
+            let finished = expectation(description: "Session \(session) Finished")
+            finished.expectedFulfillmentCount = utteranceCount
+            let observer = SessionObserver(finished: finished)
+            let synthesizer = RHSpeechSynthesizer()
+            synthesizer.delegate = observer
+
+            for _ in 0..<utteranceCount {
+                let utterance = RHSpeechUtterance(text: text)
+                utterance.set(voice: voice)
+                let path = keptPath ?? FileManager.default.tempFile(with: "wav")
+                paths.append(path)
+                synthesizer.synthesizeUtterance(utterance, toFileAtPath: path)
+            }
+
+            expectations.append(finished)
+            observers.append(observer)
+            synthesizers.append(synthesizer)
+        }
+        wait(for: expectations, timeout: 120)
+        let seconds = Date().timeIntervalSince(start)
+
+        let outputs = try paths.map { path -> Data in
+            let data = try Data(contentsOf: URL(fileURLWithPath: path))
+            if path != keptPath {
+                try FileManager.default.removeItem(atPath: path)
+            }
+            return data
+        }
+        return (outputs, seconds)
+    }
+}
@@ -0,0 +1,215 @@
+//
+//  RHUtteranceCacheTests.swift
+//  RHVoiceAppTests
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+//
+
+import XCTest
+import AVFAudio
+
+import RHVoice
+@testable import RHVoiceApp
+
+final class RHUtteranceCacheTests: XCTestCase {
+
+    /// What VoiceOver sends while user moves around a typical settings screen
+    private let screenReaderTrace = [
+        "Settings", "heading level 1", "General", "button", "Accessibility", "button",
+        "Privacy", "button", "Back", "button", "General", "button", "About", "button",
+        "Software Update", "button", "Back", "button", "heading level 2", "Storage", "button",
+        "Back", "button", "Accessibility", "button", "VoiceOver", "On", "switch button", "Back", "button"
+    ]
+
+    var synthesizerUnderTest: RHSpeechSynthesizer?
+    var synthesizerFinished: (() -> Void)?
+
+    override func setUpWithError() throws {
+        try super.setUpWithError()
+        removeAllInstlledVoicesAndLangauges()
+        synthesizerUnderTest = RHSpeechSynthesizer()
+        synthesizerUnderTest?.delegate = self
+    }
+
+    override func tearDownWithError() throws {
+        synthesizerUnderTest = nil
+        synthesizerFinished = nil
+        removeAllInstlledVoicesAndLangauges()
+        try super.tearDownWithError()
+    }
+
+    func testCachedAudioIsIdentical() throws {
+        let voice = try installAnySpeechVoice()
+        let cache = RHUtteranceCache(memoryCapacity: 1024 * 1024)
+        synthesizerUnderTest?.utteranceCache = cache
+
+        let miss = try synthesize(text: "heading level 2", voice: voice)
+        XCTAssertEqual(cache.missCount, 1)
+        XCTAssertEqual(cache.entryCount, 1)
+        XCTAssertGreaterThan(cache.memoryBytes, 0)
+
+        let hit = try synthesize(text: "heading level 2", voice: voice)
+        XCTAssertEqual(cache.hitCount, 1)
+        XCTAssertEqual(miss, hit)
+
+        let otherRate = try synthesize(text: "heading level 2", voice: voice, rate: 2)
+        XCTAssertEqual(cache.missCount, 2)
+        XCTAssertNotEqual(otherRate, hit)
+    }
+
+    func testDiskTier() throws {
+        let voice = try installAnySpeechVoice()
+        let sizingCache = RHUtteranceCache(memoryCapacity: 1024 * 1024)
+        synthesizerUnderTest?.utteranceCache = sizingCache
+        let first = try synthesize(text: "Software Update", voice: voice)
+
+        /// Holds only one of two utterances of about the same size
+        let cache = RHUtteranceCache(memoryCapacity: sizingCache.memoryBytes * 3 / 2, diskCapacity: 1024 * 1024)
+        synthesizerUnderTest?.utteranceCache = cache
+        _ = try synthesize(text: "Software Update", voice: voice)
+        _ = try synthesize(text: "Software Update", voice: voice, rate: 1.1)
+        XCTAssertGreaterThan(cache.diskBytes, 0)
+
+        XCTAssertEqual(try synthesize(text: "Software Update", voice: voice), first)
+        XCTAssertEqual(cache.diskHitCount, 1)
+    }
+
+    func testScreenReaderTraceReplay() throws {
+        try skipUnlessBenchmarking()
+        let voice = try installAnySpeechVoice()
+
+        let uncached = try replayTrace(voice: voice)
+        let cache = RHUtteranceCache(memoryCapacity: 4 * 1024 * 1024)
+        synthesizerUnderTest?.utteranceCache = cache
+        let cached = try replayTrace(voice: voice)
+
+        Log.debug(type: .tests, "Screen reader trace. Uncached: \(uncached)s, cached: \(cached)s, " +
+                                "hits: \(cache.hitCount), misses: \(cache.missCount), bytes: \(cache.memoryBytes)")
+        XCTAssertEqual(Int(cache.missCount), Set(screenReaderTrace).count)
+        XCTAssertEqual(Int(cache.hitCount), screenReaderTrace.count - Set(screenReaderTrace).count)
+        XCTAssertLessThan(cached, uncached)
+    }
+
+    /// Re-reads a paragraph at five volumes and at five rates. Volume changes replay cached audio, rate changes need the engine
+    func testRereadingAtOtherVolumesAndRates() throws {
+        let voice = try installAnySpeechVoice()
+        let paragraph = RHSpeechSynthesizerTestData.data[0].text
+        let cache = RHUtteranceCache(memoryCapacity: 16 * 1024 * 1024)
+        synthesizerUnderTest?.utteranceCache = cache
+
+        let volumes = [1.0, 0.5, 0.8, 1.2, 0.3]
+        var start = Date()
+        let audio = try volumes.map { try synthesize(text: paragraph, voice: voice, volume: $0) }
+        let volumeSeconds = Date().timeIntervalSince(start)
+        XCTAssertEqual(cache.missCount, 1)
+        XCTAssertEqual(Int(cache.hitCount), volumes.count - 1)
+        XCTAssertNotEqual(audio[0], audio[1])
+
+        start = Date()
+        for rate in [0.6, 0.8, 1.2, 1.5, 2.0] {
+            _ = try synthesize(text: paragraph, voice: voice, rate: rate)
+        }
+        let rateSeconds = Date().timeIntervalSince(start)
+
+        Log.debug(type: .tests, "Re-reading at five volumes: \(volumeSeconds)s, at five rates: \(rateSeconds)s, " +
+                                "hits: \(cache.hitCount), misses: \(cache.missCount)")
+        XCTAssertLessThan(volumeSeconds, rateSeconds)
+    }
+
+    /// Cached audio is recorded at volume 1 and scaled on replay, so it has to stay close to what the engine makes at that volume
+    func testCachedAudioAtOtherVolumesMatchesEngine() throws {
+        let voice = try installAnySpeechVoice()
+        let text = "Software Update"
+        let cache = RHUtteranceCache(memoryCapacity: 1024 * 1024)
+
+        for volume in [0.5, 2.0] {
+            synthesizerUnderTest?.utteranceCache = nil
+            let engine = try samples(of: synthesize(text: text, voice: voice, volume: volume))
+
+            synthesizerUnderTest?.utteranceCache = cache
+            let miss = try samples(of: synthesize(text: text, voice: voice, volume: volume))
+            let hit = try samples(of: synthesize(text: text, voice: voice, volume: volume))
+
+            for cached in [miss, hit] {
+                XCTAssertEqual(cached.count, engine.count, "Volume \(volume)")
+                let difference = zip(cached, engine).map { abs($0 - $1) }.max() ?? 0
+                XCTAssertLessThan(difference, 0.01, "Volume \(volume)")
+            }
+        }
+        XCTAssertEqual(cache.missCount, 1)
+        XCTAssertEqual(cache.hitCount, 3)
+    }
+
+    private func replayTrace(voice: RHSpeechSynthesisVoice) throws -> TimeInterval {
+        let start = Date()
+        for text in screenReaderTrace {
+            _ = try synthesize(text: text, voice: voice)
+        }
+        return Date().timeIntervalSince(start)
+    }
+
+    private func synthesize(text: String, voice: RHSpeechSynthesisVoice, rate: Double = 1, volume: Double = 1) throws -> Data {
+        let outputFilePath = FileManager.default.tempFile(with: "wav")
+        let utterance = RHSpeechUtterance(text: text)
+        utterance.set(voice: voice)
+        utterance.rate = rate
+        utterance.volume = volume
+
+        let finished = expectation(description: "Synthesizer Finished")
+        synthesizerFinished = {
+            finished.fulfill()
+        }
+        synthesizerUnderTest?.synthesizeUtterance(utterance, toFileAtPath: outputFilePath)
+        wait(for: [finished], timeout: 3)
+
+        let result = try Data(contentsOf: URL(fileURLWithPath: outputFilePath))
+        try FileManager.default.removeItem(atPath: outputFilePath)
+        return result
+    }
+
+    /// Samples of a mono WAV file in -1...1 range
+    private func samples(of audio: Data) throws -> [Float] {
+        let path = FileManager.default.tempFile(with: "wav")
+        try audio.write(to: URL(fileURLWithPath: path))
+        defer {
+            try? FileManager.default.removeItem(atPath: path)
+        }
+
+        let audioFile = try AVAudioFile(forReading: URL(fileURLWithPath: path))
+        let buffer = try XCTUnwrap(AVAudioPCMBuffer(pcmFormat: audioFile.processingFormat,
+                                                    frameCapacity: AVAudioFrameCount(audioFile.length)))
+        try audioFile.read(into: buffer)
+        let channel = try XCTUnwrap(buffer.floatChannelData)[0]
+        return Array(UnsafeBufferPointer(start: channel, count: Int(buffer.frameLength)))
+    }
+}
+
+extension RHUtteranceCacheTests: RHSpeechSynthesizerDelegate {
+    func speechSynthesizer(_ speechSynthesizer: RHSpeechSynthesizer, didFinish utterance: RHSpeechUtterance) {
+        synthesizerFinished?()
+    }
+
+    func speechSynthesizer(_ speechSynthesizer: RHSpeechSynthesizer, didFailToSynthesize utterance: RHSpeechUtterance, withError error: Error?) {
+        XCTFail("Failed to synthesize: \(String(describing: error))")
+        synthesizerFinished?()
+    }
+}
@@ -0,0 +1,140 @@
+//
+//  RHVoiceEngineWarmUpTests.swift
+//  RHVoiceAppTests
+//
+//  Copyright (C) 2022–2024 Ihor Shevchuk
+//  Copyright (C) 2025 Non-Routine LLC
+//  Contact: contact@nonroutine.com
+//
+//  SPDX-License-Identifier: GPL-3.0-or-later
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+//
+
+import XCTest
+
+import RHVoice
+@testable import RHVoiceApp
+
+final class RHVoiceEngineWarmUpTests: XCTestCase {
+
+
+    var synthesizerUnderTest: RHSpeechSynthesizer?
+    var synthesizerFinished: (() -> Void)?
+
+    override func setUpWithError() throws {
+        try super.setUpWithError()
+        removeAllInstlledVoicesAndLangauges()
+        synthesizerUnderTest = RHSpeechSynthesizer()
+        synthesizerUnderTest?.delegate = self
+    }
+
+    override func tearDownWithError() throws {
+        synthesizerUnderTest = nil
+        synthesizerFinished = nil
+        removeAllInstlledVoicesAndLangauges()
+        try super.tearDownWithError()
+    }
+
+    func testRecreateEngineIfDataChangedKeepsEngine() throws {
+        _ = try instalAnyVoice()
+        let bridge = RHVoiceBridge.sharedInstance()
+        bridge.recreateEngine()
+        XCTAssertFalse(bridge.recreateEngineIfDataChanged())
+
+        let marker = URL(fileURLWithPath: bridge.params.dataPath).appendingPathComponent("voices/warm-up-marker")
+        try Data([1]).write(to: marker)
+        defer {
+            try? FileManager.default.removeItem(at: marker)
+        }
+        XCTAssertTrue(bridge.recreateEngineIfDataChanged())
+        XCTAssertFalse(bridge.recreateEngineIfDataChanged())
+    }
+
+    func testRecreateEngineIfLogParamsChanged() throws {
+        _ = try instalAnyVoice()
+        let bridge = RHVoiceBridge.sharedInstance()
+        let minimumLogLevel = bridge.params.minimumLogLevel
+        defer {
+            bridge.params.minimumLogLevel = minimumLogLevel
+            bridge.recreateEngine()
+        }
+        bridge.recreateEngine()
+
+        bridge.params.minimumLogLevel = minimumLogLevel == RHVoiceLogLevelError ? RHVoiceLogLevelTrace : RHVoiceLogLevelError
+        XCTAssertTrue(bridge.recreateEngineIfDataChanged())
+        XCTAssertFalse(bridge.recreateEngineIfDataChanged())
+    }
+
+    func testStartupAndFirstUtteranceLatency() throws {
+        try skipUnlessBenchmarking()
+        let voice = try installCustomVoice()
+        let bridge = RHVoiceBridge.sharedInstance()
+
+        let coldStart = measureTime { bridge.recreateEngine() }
+        let warmStart = measureTime { XCTAssertFalse(bridge.recreateEngineIfDataChanged()) }
+        Log.debug(type: .tests, "Engine startup. Cold: \(coldStart)s, warm: \(warmStart)s")
+
+        let coldUtterance = try firstUtteranceLatency(voice: voice)
+        bridge.recreateEngine()
+        let prewarmed = expectation(description: "Voice Prewarmed")
+        synthesizerUnderTest?.prewarmVoice(voice) {
+            prewarmed.fulfill()
+        }
+        wait(for: [prewarmed], timeout: 10)
+        let warmUtterance = try firstUtteranceLatency(voice: voice)
+        Log.debug(type: .tests, "First utterance. Cold: \(coldUtterance)s, prewarmed: \(warmUtterance)s")
+
+        XCTAssertLessThan(warmStart, coldStart)
+        XCTAssertLessThan(warmUtterance, coldUtterance)
+    }
+
+    private func firstUtteranceLatency(voice: RHSpeechSynthesisVoice) throws -> TimeInterval {
+        let outputFilePath = FileManager.default.tempFile(with: "wav")
+        let utterance = RHSpeechUtterance(text: "Привет.")
+        utterance.set(voice: voice)
+
+        let finished = expectation(description: "Synthesizer Finished")
+        synthesizerFinished = {
+            finished.fulfill()
+        }
+
+        let start = Date()
+        synthesizerUnderTest?.synthesizeUtterance(utterance, toFileAtPath: outputFilePath)
+        wait(for: [finished], timeout: 10)
+        let result = Date().timeIntervalSince(start)
+
+        try FileManager.default.removeItem(atPath: outputFilePath)
+        return result
+    }
+
+    private func measureTime(_ block: () -> Void) -> TimeInterval {
+        let start = Date()
+        block()
+        return Date().timeIntervalSince(start)
+    }
+}
+
+extension RHVoiceEngineWarmUpTests: RHSpeechSynthesizerDelegate {
+    func speechSynthesizer(_ speechSynthesizer: RHSpeechSynthesizer, didFinish utterance: RHSpeechUtterance) {
+        synthesizerFinished?()
+    }
+
+    func speechSynthesizer(_ speechSynthesizer: RHSpeechSynthesizer, didFailToSynthesize utterance: RHSpeechUtterance, withError error: Error?) {
+        XCTFail("Failed to synthesize: \(String(describing: error))")
+        synthesizerFinished?()
+    }
+}
@@ -138,20 +138,20 @@ struct RHSpeechSynthesizerTestData {
             RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 236640, textRange: NSRange(location: 144, length: 9))
         ]),
         RHSpeechSynthesizerTestData(text: "😆 😅 😂 🤣", markers: [
-            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkSentence, byteSampleOffset: 0, textRange: NSRange(location: 7, length: 10)),
-            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 960, textRange: NSRange(location: 7, length: 1)),
-            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 960, textRange: NSRange(location: 10, length: 1)),
-            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 960, textRange: NSRange(location: 13, length: 1)),
-            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 960, textRange: NSRange(location: 16, length: 1))
+            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkSentence, byteSampleOffset: 0, textRange: NSRange(location: 7, length: 11)),
+            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 960, textRange: NSRange(location: 7, length: 2)),
+            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 960, textRange: NSRange(location: 10, length: 2)),
+            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 960, textRange: NSRange(location: 13, length: 2)),
+            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 960, textRange: NSRange(location: 16, length: 2))
         ]),
         RHSpeechSynthesizerTestData(text: "😆", markers: [
-            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkSentence, byteSampleOffset: 0, textRange: NSRange(location: 7, length: 1)),
-            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 960, textRange: NSRange(location: 7, length: 1))
+            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkSentence, byteSampleOffset: 0, textRange: NSRange(location: 7, length: 2)),
+            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 960, textRange: NSRange(location: 7, length: 2))
         ]),
         RHSpeechSynthesizerTestData(text: "Test:😆", markers: [
             RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkSentence, byteSampleOffset: 0, textRange: NSRange(location: 7, length: 5)),
             RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 960, textRange: NSRange(location: 7, length: 5)),
-            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkSentence, byteSampleOffset: 18960, textRange: NSRange(location: 12, length: 1)),
-            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 19920, textRange: NSRange(location: 12, length: 1))])
+            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkSentence, byteSampleOffset: 18960, textRange: NSRange(location: 12, length: 2)),
+            RHSpeechMarker(mark: RHSpeechSynthesisMarkerMarkWord, byteSampleOffset: 19920, textRange: NSRange(location: 12, length: 2))])
     ]
 }
@@ -27,6 +27,7 @@
 import XCTest
 import Foundation
 
+import RHVoice
 @testable import RHVoiceApp
 
 extension XCTestCase {
@@ -91,6 +92,56 @@ extension XCTestCase {
         return (voice, language)
     }
 
+    /// Installs the first voice of `languageCode`, or of any language, and returns it as loaded by engine
+    func installAnySpeechVoice(languageCode: String? = nil) throws -> RHSpeechSynthesisVoice {
+        let voice: Voice
+        if let languageCode {
+            guard let language = languages?.first(where: { $0.code == languageCode }), let languageVoice = language.voices.first else {
+                throw XCTSkip("No voice available for \(languageCode)")
+            }
+            install(voice: languageVoice, for: language)
+            voice = languageVoice
+        } else {
+            (voice, _) = try instalAnyVoice()
+        }
+        guard let installedVoice = voice.installedVoice else {
+            XCTFail("InstalledVoice can't be nil")
+            throw UnitTestErrors.installFailed
+        }
+        return installedVoice
+    }
+
+    var customVoiceName: String {
+        return "Vladislav"
+    }
+
+    /// Installs Russian language with the `custom-voices/vladislav` voice from the repository
+    func installCustomVoice() throws -> RHSpeechSynthesisVoice {
+        let customVoiceFolder = URL(fileURLWithPath: #filePath)
+            .deletingLastPathComponent()
+            .deletingLastPathComponent()
+            .deletingLastPathComponent()
+            .appendingPathComponent("custom-voices/vladislav")
+        guard FileManager.default.fileExists(atPath: customVoiceFolder.path) else {
+            throw XCTSkip("No custom voice data at \(customVoiceFolder.path)")
+        }
+        guard let language = languages?.first(where: { $0.code == "ru" }), let voice = language.voices.first else {
+            throw XCTSkip("No Russian language available to load \(customVoiceName)")
+        }
+        install(voice: voice, for: language)
+
+        let dataFolder = URL(fileURLWithPath: RHVoiceBridge.sharedInstance().params.dataPath)
+        try FileManager.default.copyItem(at: customVoiceFolder,
+                                         to: FileManager.voicesFolder(dataFolder).appendingPathComponent("vladislav"))
+        RHVoiceBridge.sharedInstance().recreateEngine()
+
+        guard let result = RHSpeechSynthesisVoice.speechVoices().first(where: { $0.name == customVoiceName }) else {
+            XCTFail("\(customVoiceName) is not loaded by engine")
+            throw UnitTestErrors.installFailed
+        }
+        return result
+    }
+
     func newVoiceValue(for voice: Voice) throws -> Voice {
 
         guard let languages else {
@@ -121,6 +172,13 @@ extension XCTestCase {
         return result
     }
 
+    /// Benchmarks take minutes and mostly report numbers. They run only with the RHVoiceAppBenchmarks test plan,
+    /// which sets `RHVOICE_BENCHMARKS`
+    func skipUnlessBenchmarking() throws {
+        try XCTSkipUnless(ProcessInfo.processInfo.environment["RHVOICE_BENCHMARKS"] == "1",
+                          "Benchmark. Run it with the RHVoiceAppBenchmarks test plan")
+    }
+
     func removeAllInstlledVoicesAndLangauges() {
         try? FileManager.default.removeItem(at: FileManager.default.rhvoiceDataPathURLInDocuments)
         if let rhvoiceDataPathURL = FileManager.default.rhvoiceDataPathURL {
@@ -24,7 +24,6 @@
 //  along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 
-import Accelerate
 import AVFoundation
 import CoreAudio
 import RHVoice
@@ -38,8 +37,15 @@ public final class RHVoiceExtensionAudioUnit: AVSpeechSynthesisProviderAudioUnit
 
     private var format: AVAudioFormat
     private let sampleRate = 24000.0
-    private let outputRecurseCallNumberMax: UInt32 = 200
-    private let baseDelayMicroseconds: UInt32 = 500
+    /// Longest time render call sleeps waiting for the engine before returning what is available
+    private let renderWaitTimeout: TimeInterval = 0.1
+    /// Ten seconds of audio. Synthesis is paused when rendering falls this much behind
+    private let audioRingBufferCapacity = 240000
+    /// Screen readers repeat short strings a lot. A few MB hold hundreds of them and stay well within extension memory limit
+    private let utteranceCacheMemoryCapacity: UInt = 4 * 1024 * 1024
+    private let utteranceCacheDiskCapacity: UInt = 32 * 1024 * 1024
+    private static let lastUsedVoiceNameKey = "RHVoiceExtensionLastUsedVoiceName"
+    private var prewarmedVoiceNames: Set<String> = []
     
     @objc override init(componentDescription: AudioComponentDescription, options: AudioComponentInstantiationOptions) throws {
         
@@ -62,13 +68,9 @@ public final class RHVoiceExtensionAudioUnit: AVSpeechSynthesisProviderAudioUnit
     public override func deallocateRenderResources() {
         super.deallocateRenderResources()
         cleanUp()
-        synthesizer = nil
     }
     
-    private var outputDataQueue = DispatchQueue(label: "RHVoiceExtensionAudioUnit.outputDataQueue", qos: .userInteractive)
-    private var outputData: [Float] = []
     private var outputOffset = 0
-    private var outputRecurseCallNumber = 0
     private var currentSubscriptionsHash: Int = 0
     private var currentVoicesSettingsHash: Int = 0
     private var supportedVoices: [RHSpeechSynthesisProviderVoice] {
@@ -118,40 +120,29 @@ public final class RHVoiceExtensionAudioUnit: AVSpeechSynthesisProviderAudioUnit
       renderEvents: UnsafePointer<AURenderEvent>?,
       renderPull: AURenderPullInputBlock?
     ) -> AUAudioUnitStatus {
-        guard let utteranceClient else {
+        guard let utteranceClient, let audioRingBuffer = utteranceClient.audioRingBuffer else {
             actionFlags.pointee = .unitRenderAction_PostRenderError
             Log.debug(type: .synthesizer, "Utterance Client is nil while request for rendering came.")
             return kAudioComponentErr_InstanceInvalidated
         }
         
         let intFrameCount = Int(frameCount)
-        var outputDataCount = 0
-        outputDataQueue.sync { [weak self] in
-            outputDataCount = self?.outputData.count ?? 0
-        }
-        let coutOfDataAvailable = min(outputDataCount - outputOffset, intFrameCount)
+        var coutOfDataAvailable = min(audioRingBuffer.availableFrames, intFrameCount)
         
-        if coutOfDataAvailable < intFrameCount {
-            let completedRendering = utteranceClient.completed()
-            if completedRendering && coutOfDataAvailable <= 0 {
-                Log.debug(type: .synthesizer, "Completed rendering")
-                actionFlags.pointee = .offlineUnitRenderAction_Complete
-                self.cleanUp()
-                return noErr
-            }
-            
-            outputRecurseCallNumber += 1
-            if outputRecurseCallNumber < outputRecurseCallNumberMax && !completedRendering {
-                Log.error(type: .synthesizer, "Rendering in progress no data. Trying one more time: \(outputRecurseCallNumber)")
-                pauseUntil(maxDelayFactor: outputRecurseCallNumberMax) {
-                    utteranceClient.completed()
-                }
-                return doPerformRender(actionFlags: actionFlags, timestamp: timestamp, frameCount: frameCount, outputBusNumber: outputBusNumber, outputAudioBufferList: outputAudioBufferList, renderEvents: renderEvents, renderPull: renderPull)
+        if coutOfDataAvailable < intFrameCount && !utteranceClient.completed() {
+            coutOfDataAvailable = min(utteranceClient.waitForFrames(intFrameCount, timeout: renderWaitTimeout), intFrameCount)
+            if coutOfDataAvailable < intFrameCount && !audioRingBuffer.isFinished {
+                Log.error(type: .synthesizer, "Waited \(renderWaitTimeout)s for \(intFrameCount) frames, got \(coutOfDataAvailable). Returning what have currently")
             }
-            Log.error(type: .synthesizer, "Tryied \(outputRecurseCallNumber), without luck. Returning what have currently")
         }
         
-        outputRecurseCallNumber = 0
+        let completedRendering = utteranceClient.completed() || audioRingBuffer.isFinished
+        if completedRendering && coutOfDataAvailable <= 0 {
+            Log.debug(type: .synthesizer, "Completed rendering")
+            actionFlags.pointee = .offlineUnitRenderAction_Complete
+            self.cleanUp()
+            return noErr
+        }
         
         outputAudioBufferList.pointee.mNumberBuffers = 1
         var unsafeBuffer = UnsafeMutableAudioBufferListPointer(outputAudioBufferList)[0]
@@ -159,42 +150,17 @@ public final class RHVoiceExtensionAudioUnit: AVSpeechSynthesisProviderAudioUnit
         frames.update(repeating: 0, count: intFrameCount)
         unsafeBuffer.mNumberChannels = 1
         
-        unsafeBuffer.mDataByteSize = UInt32(coutOfDataAvailable * MemoryLayout<Float32>.size)
-        
-        var outputFrames: [Float] = []
-        outputDataQueue.sync { [weak self] in
-            guard let self else {
-                return
-            }
-            if self.outputOffset >= 0
-            && self.outputOffset < self.outputData.count
-            && (coutOfDataAvailable + self.outputOffset) <= self.outputData.count {
-                outputFrames = Array(self.outputData[self.outputOffset..<(coutOfDataAvailable + self.outputOffset)])
-            }
-        }
+        let renderedFrames = audioRingBuffer.readFrames(frames, count: coutOfDataAvailable)
+        unsafeBuffer.mDataByteSize = UInt32(renderedFrames * MemoryLayout<Float32>.size)
         
-        for (index, frame) in outputFrames.enumerated() {
-            frames[index] = frame
-        }
-        self.outputOffset += coutOfDataAvailable
+        self.outputOffset += renderedFrames
         actionFlags.pointee = .offlineUnitRenderAction_Render
         
-        Log.debug(type: .synthesizer, "Rendered: \(coutOfDataAvailable) outputOffset: \(outputOffset).")
+        Log.debug(type: .synthesizer, "Rendered: \(renderedFrames) outputOffset: \(outputOffset).")
         
         return noErr
     }
     
-    private func pauseUntil(maxDelayFactor: UInt32, or condition: @escaping () -> Bool) {
-        let maxDelaySeconds = Double(baseDelayMicroseconds * maxDelayFactor) / 1_000_000
-        let checkIntervalSeconds = maxDelaySeconds / 5.0
-
-        let startTime = Date()
-        
-        while !condition() && Date().timeIntervalSince(startTime) < maxDelaySeconds {
-            RunLoop.current.run(mode: .default, before: Date().addingTimeInterval(checkIntervalSeconds))
-        }
-    }
-
     public override func synthesizeSpeechRequest(_ speechRequest: AVSpeechSynthesisProviderRequest) {
         self.cancelSpeechRequest()
         self.request = speechRequest
@@ -209,11 +175,14 @@ public final class RHVoiceExtensionAudioUnit: AVSpeechSynthesisProviderAudioUnit
         updateSettingsIfNeeded()
 
         let utterance = RHSpeechUtterance(ssml: ssml)
+        utterance.priority = RHSpeechUtterancePriorityInterrupt
         if let voice = rhVoiceFromSystem(voice: speechRequest.voice) {
             utterance.set(voice: voice)
+            prewarmedVoiceNames.insert(voice.name)
+            UserDefaults.standard.set(voice.name, forKey: Self.lastUsedVoiceNameKey)
         }
 
-        let client = RHSpeechUtteranceClient(audioBufferSize: 50)
+        let client = RHSpeechUtteranceClient(audioBufferSize: 50, audioRingBufferCapacity: audioRingBufferCapacity)
         client.markerDelegate = self
         self.utteranceClient = client
         synthesizer?.synthesizeUtterance(utterance, client: client)
@@ -229,6 +198,7 @@ public final class RHVoiceExtensionAudioUnit: AVSpeechSynthesisProviderAudioUnit
         get {
             Log.debug(type: .synthesizer, "Number of voices. In")
             let result = supportedVoices.avVoices
+            prewarmLastUsedVoiceIfNeeded()
             Log.debug(type: .synthesizer, "Number of voices. Out:\(result.count)")
             return result
         }
@@ -245,10 +215,6 @@ public final class RHVoiceExtensionAudioUnit: AVSpeechSynthesisProviderAudioUnit
         utteranceClient?.cancel()
         request = nil
         metaDataMarkers = []
-        outputDataQueue.sync { [weak self] in
-            guard let self else { return }
-            self.outputData = []
-        }
         outputOffset = 0
         utteranceClient = nil
     }
@@ -261,9 +227,30 @@ public final class RHVoiceExtensionAudioUnit: AVSpeechSynthesisProviderAudioUnit
         initParams.logger = self
         let rhVoiceBridge = RHVoiceBridge.sharedInstance()
         rhVoiceBridge.params = initParams
-        synthesizer = RHSpeechSynthesizer()
+        if synthesizer == nil {
+            let synthesizer = RHSpeechSynthesizer()
+            synthesizer.utteranceCache = RHUtteranceCache(memoryCapacity: utteranceCacheMemoryCapacity,
+                                                          diskCapacity: utteranceCacheDiskCapacity)
+            self.synthesizer = synthesizer
+        }
         updateSettingsIfNeeded()
     }
+
+    /// Loads the voice used by the previous request in background, so the first request after
+    /// the extension is launched does not wait for voice data. Other voices are loaded on demand
+    /// to stay within extension memory limit.
+    private func prewarmLastUsedVoiceIfNeeded() {
+        guard let name = UserDefaults.standard.string(forKey: Self.lastUsedVoiceNameKey),
+              !prewarmedVoiceNames.contains(name) else {
+            return
+        }
+        guard let voice = RHSpeechSynthesisVoice.speechVoices().first(where: { $0.name == name }) else {
+            return
+        }
+        prewarmedVoiceNames.insert(name)
+        Log.debug(type: .synthesizer, "Prewarming voice: \(name)")
+        synthesizer?.prewarmVoice(voice, completion: nil)
+    }
     
     private func updateSettingsIfNeeded() {
         let voicesSettingsHash = SettingsStore.shared.voicesSettings.hashValue
@@ -277,9 +264,10 @@ public final class RHVoiceExtensionAudioUnit: AVSpeechSynthesisProviderAudioUnit
     var metaDataMarkers: [AVSpeechSynthesisMarker] = []
     
     var rhSpeechVoices: [RHSpeechSynthesisVoice] {
-        synthesizer = nil
         initRHVoice()
-        RHVoiceBridge.sharedInstance().recreateEngine()
+        if RHVoiceBridge.sharedInstance().recreateEngineIfDataChanged() {
+            engineRecreated()
+        }
         let result = RHSpeechSynthesisVoice.speechVoices()
         return result
     }
@@ -296,24 +284,20 @@ public final class RHVoiceExtensionAudioUnit: AVSpeechSynthesisProviderAudioUnit
             return voice
         }
         
-        RHVoiceBridge.sharedInstance().recreateEngine()
+        guard RHVoiceBridge.sharedInstance().recreateEngineIfDataChanged() else {
+            return nil
+        }
+        engineRecreated()
         return doGetRHVoiceFromSystem(voice: voice)
     }
+
+    private func engineRecreated() {
+        prewarmedVoiceNames.removeAll()
+        synthesizer?.utteranceCache?.removeAllEntries()
+    }
 }
 
 extension RHVoiceExtensionAudioUnit: RHSpeechUtteranceClientMarkerDelegate {
-    public func utteranceClientDidReceiveSamples(_ samples: UnsafePointer<Int16>, withSize count: Int) {
-        let buf = UnsafeBufferPointer(start: samples, count: count)
-        let array = Array(buf)
-        outputDataQueue.async { [weak self] in
-            guard let self else {
-                return
-            }
-            let resampled = vDSP.multiply(Float(1.0/32767.0), vDSP.integerToFloatingPoint(array, floatingPointType: Float.self))
-            self.outputData.append(contentsOf: resampled)
-        }
-    }
-    
     public func utteranceClientDidReceive(_ markers: [RHSpeechSynthesisMarker]) {
         guard let speechSynthesisOutputMetadataBlock = self.speechSynthesisOutputMetadataBlock else {
             return